@@ -1,8 +1,16 @@
 #include "AbstractSyntaxTree.h"
 #include "ParserFunc.h"
+#include "Memoization.h"
+#include "Parallel.h"
+#include "Sampler.h"
+#include "Timeline.h"
+#include "LiveMetrics.h"
+#include "PGOProfile.h"
+#include "LazyParse.h"
 
 #include <cfloat>
 #include <cmath>
+#include <sstream>
 
 #include "HelpTools.h"
 
@@ -78,30 +86,26 @@ void ASTIncrOpNode::run(InterpreterState& int_st, ExecutionState& exec_st)
 		double new_val;
 		std::string var_name;
 		unsigned int ind; // only for array indexing, useless in case of variable
+		ArrayHandle* array = NULL;
 		if (left->get_op() == INDEX) { // modify array element
 			double ind_d = int_st.data_stack.top();
 			int_st.data_stack.pop();
 			if (ind_d < 0.0) calc_unreachable("Array index less than zero");
 			if (ind_d > 1e9) calc_unreachable("Array index too high");
 			ind = static_cast<unsigned int>(ind_d);
-			ASTBinaryOpNode* index = dynamic_cast<ASTBinaryOpNode*>(left);
-			ASTLeafVar* leafvar = dynamic_cast<ASTLeafVar*>(index->get(0));
-			unsigned int var_id = leafvar->get();
-			std::map<unsigned int, std::pair<std::string, unsigned int> >::iterator sym_table_it = int_st.sym_table->find(var_id);
-			if (sym_table_it == int_st.sym_table->end()) calc_unreachable("Array id not found");
-			if (sym_table_it->second.second <= ind) calc_unreachable("Array index out of range");
-			std::map<unsigned int, std::vector<double> >::iterator arrays_it = exec_st.arrays->find(var_id);
-			if (arrays_it == exec_st.arrays->end()) {
-				std::vector<double> temp_array(sym_table_it->second.second, 0.0);
-				(*exec_st.arrays)[var_id] = temp_array;
-			}
-			val = (*exec_st.arrays)[var_id][ind];
+			ASTIndexNode* index = dynamic_cast<ASTIndexNode*>(left);
+			array = &exec_st.arrays[index->get_slot()];
+			if (array->length <= ind) calc_unreachable("Array index out of range");
+			val = array->load(int_st.arena, ind);
 
-			var_name = sym_table_it->second.first;
+			if (int_st.trace != NULL) {
+				ASTLeafVar* leafvar = dynamic_cast<ASTLeafVar*>(index->get(0));
+				var_name = int_st.sym_table->find(leafvar->get())->second.first;
+			}
 		} else if (left->get_op() == VARIABLE) { // modify variable
 			ASTLeafVar* leafvar = dynamic_cast<ASTLeafVar*>(left);
 			unsigned int var_id = leafvar->get();
-			std::map<unsigned int, double>::iterator val_iterator = exec_st.variables->find(var_id);
+			VariableMap::iterator val_iterator = exec_st.variables->find(var_id);
 			if (val_iterator == exec_st.variables->end()) calc_unreachable("Variable not initialized");
 			val = val_iterator->second;
 
@@ -132,19 +136,15 @@ void ASTIncrOpNode::run(InterpreterState& int_st, ExecutionState& exec_st)
 		}
 
 		if (left->get_op() == INDEX) {
-			ASTBinaryOpNode* index = dynamic_cast<ASTBinaryOpNode*>(left);
-			ASTLeafVar* leafvar = dynamic_cast<ASTLeafVar*>(index->get(0));
-			unsigned int var_id = leafvar->get();
-			std::map<unsigned int, std::vector<double> >::iterator arrays_it = exec_st.arrays->find(var_id);
-			arrays_it->second[ind] = new_val;
-			std::cout << var_name << "[" << ind << "] = " << new_val << std::endl;
+			array->store(int_st.arena, ind, new_val);
+			if (int_st.trace != NULL) *int_st.trace << var_name << "[" << ind << "] = " << new_val << std::endl;
 		} else if (left->get_op() == VARIABLE) {
 			ASTLeafVar* leafvar = dynamic_cast<ASTLeafVar*>(left);
 			unsigned int var_id = leafvar->get();
-			std::map<unsigned int, double>::iterator val_iterator = exec_st.variables->find(var_id);
+			VariableMap::iterator val_iterator = exec_st.variables->find(var_id);
 			val_iterator->second = new_val;
 			if (var_name == "result") exec_st.result = new_val;
-			std::cout << var_name << " = " << new_val << std::endl;
+			if (int_st.trace != NULL) *int_st.trace << var_name << " = " << new_val << std::endl;
 		}
 
 		int_st.data_stack.push(val);
@@ -162,6 +162,13 @@ void ASTBinaryOpNode::run(InterpreterState& int_st, ExecutionState& exec_st)
 {
 	int op = get_op();
 
+	if (exec_st.cmd_state == 0 && m_fork && int_st.pool != NULL && int_st.fork_depth < int_st.max_fork_depth)
+	{
+		run_forked(int_st, exec_st, this); // both children at once
+		exec_st.cmd_state = 2;
+		return;
+	}
+
 	if (exec_st.cmd_state == 0) // call to child 2
 	{
 		exec_st.cmd_state++;
@@ -267,17 +274,9 @@ void ASTIndexNode::run(InterpreterState& int_st, ExecutionState& exec_st)
 			if (ind_d < 0.0) calc_unreachable("Array index less than zero");
 			if (ind_d > 1e9) calc_unreachable("Array index too high");
 			unsigned int ind = static_cast<unsigned int>(ind_d);
-			ASTLeafVar* leafvar = dynamic_cast<ASTLeafVar*>(get(0));
-			unsigned int var_id = leafvar->get();
-			std::map<unsigned int, std::pair<std::string, unsigned int> >::iterator sym_table_it = int_st.sym_table->find(var_id);
-			if (sym_table_it == int_st.sym_table->end()) calc_unreachable("Array id not found");
-			if (sym_table_it->second.second <= ind) calc_unreachable("Array index out of range");
-			std::map<unsigned int, std::vector<double> >::iterator arrays_it = exec_st.arrays->find(var_id);
-			if (arrays_it == exec_st.arrays->end()) {
-				std::vector<double> temp_array(sym_table_it->second.second, 0.0);
-				(*exec_st.arrays)[var_id] = temp_array;
-			}
-			int_st.data_stack.push((*exec_st.arrays)[var_id][ind]);
+			ArrayHandle& array = exec_st.arrays[m_slot];
+			if (array.length <= ind) calc_unreachable("Array index out of range");
+			int_st.data_stack.push(array.load(int_st.arena, ind));
 			break;
 		}
 		default:
@@ -334,21 +333,16 @@ void ASTAssignNode::run(InterpreterState& int_st, ExecutionState& exec_st)
 				if (ind_d < 0.0) calc_unreachable("Array index less than zero");
 				if (ind_d > 1e9) calc_unreachable("Array index too high");
 				unsigned int ind = static_cast<unsigned int>(ind_d);
-				ASTBinaryOpNode* index = dynamic_cast<ASTBinaryOpNode*>(left);
-				ASTLeafVar* leafvar = dynamic_cast<ASTLeafVar*>(index->get(0));
-				unsigned int var_id = leafvar->get();
-				std::map<unsigned int, std::pair<std::string, unsigned int> >::iterator sym_table_it = int_st.sym_table->find(var_id);
-				if (sym_table_it == int_st.sym_table->end()) calc_unreachable("Array id not found");
-				if (sym_table_it->second.second <= ind) calc_unreachable("Array index out of range");
-				std::map<unsigned int, std::vector<double> >::iterator arrays_it = exec_st.arrays->find(var_id);
-				if (arrays_it == exec_st.arrays->end()) {
-					std::vector<double> temp_array(sym_table_it->second.second, 0.0);
-					(*exec_st.arrays)[var_id] = temp_array;
+				ASTIndexNode* index = dynamic_cast<ASTIndexNode*>(left);
+				ArrayHandle& array = exec_st.arrays[index->get_slot()];
+				if (array.length <= ind) calc_unreachable("Array index out of range");
+				array.store(int_st.arena, ind, int_st.data_stack.top());
+
+				if (int_st.trace != NULL) {
+					ASTLeafVar* leafvar = dynamic_cast<ASTLeafVar*>(index->get(0));
+					var_name = int_st.sym_table->find(leafvar->get())->second.first;
+					*int_st.trace << var_name << "[" << ind << "] = " << int_st.data_stack.top() << std::endl;
 				}
-				(*exec_st.arrays)[var_id][ind] = int_st.data_stack.top();
-
-				var_name = sym_table_it->second.first;
-				std::cout << var_name << "[" << ind << "] = " << int_st.data_stack.top() << std::endl;
 			} else if (left->get_op() == VARIABLE) { // modify variable
 				ASTLeafVar* leafvar = dynamic_cast<ASTLeafVar*>(left);
 				unsigned int var_id = leafvar->get();
@@ -357,7 +351,7 @@ void ASTAssignNode::run(InterpreterState& int_st, ExecutionState& exec_st)
 				std::map<unsigned int, std::pair<std::string, unsigned int> >::iterator sym_table_it = int_st.sym_table->find(var_id);
 				var_name = sym_table_it->second.first;
 				if (var_name == "result") exec_st.result = int_st.data_stack.top();
-				std::cout << var_name << " = " << int_st.data_stack.top() << std::endl;
+				if (int_st.trace != NULL) *int_st.trace << var_name << " = " << int_st.data_stack.top() << std::endl;
 			} else {
 				calc_unreachable("Wrong modifiable");
 			}
@@ -374,6 +368,14 @@ void ASTAssignNode::run(InterpreterState& int_st, ExecutionState& exec_st)
 	calc_unreachable("Wrong cmd_state");
 }
 
+void ASTTernaryOpNode::hint_branch(SSAList& ssa) const
+{
+	const PGOProfile* profile = ssa.context().profile;
+	if (profile == NULL) return;
+	double probability = profile->branch_probability(get_location());
+	if (probability >= 0.0) dynamic_cast<SSATernaryOpNode*>(ssa.get_end())->set_probability(probability);
+}
+
 void ASTTernaryOpNode::run(InterpreterState& int_st, ExecutionState& exec_st)
 {
 	if (exec_st.cmd_state == 0) // call to child 1
@@ -398,6 +400,7 @@ void ASTTernaryOpNode::run(InterpreterState& int_st, ExecutionState& exec_st)
 		case TERNARY: {
 			double left = int_st.data_stack.top();
 			int_st.data_stack.pop();
+			if (int_st.pgo != NULL) int_st.pgo->branch(this, !double_equal(left, 0.0));
 			if (double_equal(left, 0.0)) exec_st.command = get(2);
 			else exec_st.command = get(1);
 			break;
@@ -437,6 +440,8 @@ void ASTNoRetBinaryOpNode::run(InterpreterState& int_st, ExecutionState& exec_st
 			if (int_st.data_stack.pop()) // drop condition result
 				calc_unreachable("data stack is empty");
 			if (!double_equal(left, 0.0)) { // condition true
+				if (int_st.timeline != NULL) int_st.timeline->loop_iteration(this);
+				if (int_st.pgo != NULL) int_st.pgo->loop_iteration(this);
 				exec_st.cmd_state = 2; // after calc cycle body go to while-cycle state 2
 				int_st.op_stack.push(exec_st.cmd_state);
 				exec_st.cmd_state = 0;
@@ -444,6 +449,8 @@ void ASTNoRetBinaryOpNode::run(InterpreterState& int_st, ExecutionState& exec_st
 				exec_st.command = get(1);
 				return;
 			} else {
+				if (int_st.timeline != NULL) int_st.timeline->loop_end(this);
+				if (int_st.pgo != NULL) int_st.pgo->loop_end(this);
 				int_st.data_stack.push(0.0); // put useless result of while-cycle in stack
 				exec_st.cmd_state = int_st.op_stack.top();
 				int_st.op_stack.pop();
@@ -516,6 +523,7 @@ void ASTNoRetTernaryOpNode::run(InterpreterState& int_st, ExecutionState& exec_s
 		case IF: {
 			double left = int_st.data_stack.top();
 			int_st.data_stack.pop();
+			if (int_st.pgo != NULL) int_st.pgo->branch(this, !double_equal(left, 0.0));
 			if (double_equal(left, 0.0)) exec_st.command = get(2);
 			else exec_st.command = get(1);
 			break;
@@ -545,6 +553,7 @@ void ASTFuncCallNode::run(InterpreterState& int_st, ExecutionState& exec_st)
 		std::string msg = "Function '" + m_name + "' not found in name table";
 		calc_unreachable(msg);
 	}
+	if (f->lazy != NULL) f->lazy->load(f); // first call
 	if (f->arg.size() != m_child_args.size()) {
 		std::string msg = "Wrong number of arguments in function '" + f->name + "'";
 		calc_unreachable(msg);
@@ -568,16 +577,75 @@ void ASTFuncCallNode::run(InterpreterState& int_st, ExecutionState& exec_st)
 
 	if (exec_st.cmd_state == f->arg.size()) // func call
 	{
+		int_st.calls++;
+		if (int_st.pgo != NULL) int_st.pgo->call(this, m_name);
+		if (f->memo != NULL) { // pure function, all arguments are in data stack
+			std::vector<double> args(f->arg.size());
+			for (int i = f->arg.size() - 1; i >= 0; i--) {
+				args[i] = int_st.data_stack.top();
+				int_st.data_stack.pop();
+			}
+			std::string key = MemoCache::make_key(args);
+			double cached_result;
+			std::string cached_trace;
+			if (f->memo->lookup(key, cached_result, cached_trace)) { // return cached result without calling
+				if (int_st.trace != NULL) *int_st.trace << cached_trace;
+				if (int_st.timeline != NULL) int_st.timeline->cached_call(f);
+				exec_st.result = cached_result;
+				int_st.data_stack.push(cached_result);
+				exec_st.cmd_state = int_st.op_stack.top();
+				int_st.op_stack.pop();
+				exec_st.command = int_st.command_stack.top();
+				int_st.command_stack.pop();
+				return;
+			}
+			for (unsigned int i = 0; i < args.size(); i++) {
+				int_st.data_stack.push(args[i]);
+			}
+			MemoCall* call = new MemoCall;
+			call->key = key;
+			if (int_st.trace != NULL) { // collect trace of the call to replay it later
+				call->parent_trace = int_st.trace;
+				call->trace = new std::ostringstream;
+				int_st.trace = call->trace;
+			}
+			int_st.memo_stack.push(call);
+		}
+
+		// arrays passed to function belong to caller frame
+		ArrayHandle* caller_arrays = exec_st.arrays;
+		for (unsigned int i = 0; i < f->arg.size(); i++) {
+			if (f->arg[i]->get_op() == VARIABLE) continue;
+			ASTIndexNode* index_in = dynamic_cast<ASTIndexNode*>(f->arg[i]);
+			ASTLeafVar* variable_out = dynamic_cast<ASTLeafVar*>(m_child_args[i]);
+			if (variable_out == NULL || variable_out->get_slot() < 0) calc_unreachable("Array expected in function call");
+			ArrayHandle& array_out = caller_arrays[variable_out->get_slot()];
+
+			// check sizes of in and out arrays
+			if (f->array_lengths[index_in->get_slot()] != array_out.length) calc_unreachable("Array has wrong size in function call");
+		}
+
 		exec_st.cmd_state++;
 		int_st.op_stack.push(exec_st.cmd_state);
 		int_st.command_stack.push(exec_st.command);
 		int_st.var_stack.push(exec_st.variables);
 		int_st.arr_stack.push(exec_st.arrays);
+		int_st.arena_stack.push(int_st.arena.mark());
 
 		exec_st.cmd_state = 0;
 		exec_st.command = f->body;
-		exec_st.variables = new std::map<unsigned int, double>;
-		std::map<unsigned int, std::vector<double> >* temp_arrays = new std::map<unsigned int, std::vector<double> >;
+		exec_st.variables = new VariableMap;
+		exec_st.result = 0.0; // paths not assigning result return 0, with or without cache
+		if (int_st.sampler != NULL) int_st.sampler->push(f);
+		if (int_st.timeline != NULL) int_st.timeline->call(f);
+		if (int_st.metrics != NULL) int_st.metrics->call(f);
+		exec_st.arrays = static_cast<ArrayHandle*>(int_st.arena.allocate(f->array_lengths.size() * sizeof(ArrayHandle)));
+		for (unsigned int slot = 0; slot < f->array_lengths.size(); slot++) {
+			exec_st.arrays[slot].data = NULL;
+			exec_st.arrays[slot].large = NULL;
+			exec_st.arrays[slot].length = f->array_lengths[slot];
+			exec_st.arrays[slot].borrowed = 0;
+		}
 
 		for (int i = f->arg.size() - 1; i >= 0; i--) {
 			if (f->arg[i]->get_op() == VARIABLE) {
@@ -585,34 +653,15 @@ void ASTFuncCallNode::run(InterpreterState& int_st, ExecutionState& exec_st)
 				unsigned int var_id = leafvar->get();
 				(*exec_st.variables)[var_id] = int_st.data_stack.top();
 				int_st.data_stack.pop();
-			} else { // copy array
+			} else { // borrow array, it is copied on first write
 				ASTIndexNode* index_in = dynamic_cast<ASTIndexNode*>(f->arg[i]);
-				ASTLeafVar* variable_in = dynamic_cast<ASTLeafVar*>(index_in->get(0));
-				unsigned int id_in = variable_in->get();
-
 				ASTLeafVar* variable_out = dynamic_cast<ASTLeafVar*>(m_child_args[i]);
-				unsigned int id_out = variable_out->get();
-
-				std::map<unsigned int, std::pair<std::string, unsigned int> >::iterator st_it_in = int_st.sym_table->find(id_in);
-				std::map<unsigned int, std::pair<std::string, unsigned int> >::iterator st_it_out = int_st.sym_table->find(id_out);
-
-				// check sizes of in and out arrays
-				if (st_it_in->second.second != st_it_out->second.second) calc_unreachable("Array has wrong size in function call");
-
-				// fill outer array by zero if it isn't initialized
-				std::map<unsigned int, std::vector<double> >::iterator it_out = exec_st.arrays->find(id_out);
-				if (it_out == exec_st.arrays->end()) {
-					std::vector<double> temp_array(st_it_out->second.second, 0.0);
-					(*exec_st.arrays)[id_out] = temp_array;
-				}
-
-				// copy array
-				(*temp_arrays)[id_in] = (*exec_st.arrays)[id_out];
+				ArrayHandle& array_in = exec_st.arrays[index_in->get_slot()];
+				array_in = caller_arrays[variable_out->get_slot()];
+				array_in.borrowed = 1;
 			}
 		}
 
-		exec_st.arrays = temp_arrays;
-
 		return;
 	}
 
@@ -620,10 +669,26 @@ void ASTFuncCallNode::run(InterpreterState& int_st, ExecutionState& exec_st)
 	{
 		double res = exec_st.result;
 		delete exec_st.variables;
-		delete exec_st.arrays;
+		if (int_st.sampler != NULL) int_st.sampler->pop();
+		if (int_st.timeline != NULL) int_st.timeline->ret();
+		if (int_st.metrics != NULL) int_st.metrics->ret();
+		int_st.arena.release(int_st.arena_stack.top());
+		int_st.arena_stack.pop();
+		if (f->memo != NULL) {
+			MemoCall* call = int_st.memo_stack.top();
+			int_st.memo_stack.pop();
+			std::string trace;
+			if (call->trace != NULL) {
+				trace = call->trace->str();
+				int_st.trace = call->parent_trace;
+				*int_st.trace << trace;
+			}
+			f->memo->insert(call->key, res, trace);
+			delete call;
+		}
 		int_st.data_stack.pop(); // if function has one statement, delete it result, else delete result of last statement
 		int_st.data_stack.push(res);
-		if (f->name == "main") {
+		if (f->name == int_st.entry) {
 			int_st.execution_end = 1;
 			return;
 		}
@@ -641,6 +706,25 @@ void ASTFuncCallNode::run(InterpreterState& int_st, ExecutionState& exec_st)
 	calc_unreachable("Wrong cmd_state");
 }
 
+void ASTArrayInitNode::run(InterpreterState& int_st, ExecutionState& exec_st)
+{
+	ASTLeafVar* leafvar = dynamic_cast<ASTLeafVar*>(m_array);
+	if (!m_values.empty()) {
+		exec_st.arrays[leafvar->get_slot()].store_all(int_st.arena, &m_values[0], m_values.size());
+		if (int_st.trace != NULL) { // as assignment of every element
+			const std::string& var_name = int_st.sym_table->find(leafvar->get())->second.first;
+			for (unsigned int i = 0; i < m_values.size(); i++)
+				*int_st.trace << var_name << "[" << i << "] = " << m_values[i] << '\n';
+			int_st.trace->flush();
+		}
+	}
+	int_st.data_stack.push(0.0); // push in stack useless result
+	exec_st.cmd_state = int_st.op_stack.top();
+	int_st.op_stack.pop();
+	exec_st.command = int_st.command_stack.top();
+	int_st.command_stack.pop();
+}
+
 void ASTEmptyNode::run(InterpreterState& int_st, ExecutionState& exec_st)
 {
 	int_st.data_stack.push(0.0); // push in stack useless result
@@ -15,6 +15,8 @@
 #include "SSA.h"
 
 #include "HelpTools.h"
+#include "MemoryStats.h"
+#include "location.hh"
 
 static const int max_str_size = 256;
 
@@ -28,24 +30,39 @@ enum operation {
 		ADD, SUB, MUL, DIV, UNARY_MINUS, NOT,
 		POST_INC, PRE_INC, POST_DEC, PRE_DEC,
 		INDEX,
-		VARIABLE, NUMBER
+		VARIABLE, NUMBER,
+		ARRAY_INIT
 	};
 
 int double_equal(double a, double b);
 
+struct NodeProfile;
+
 class IASTNode {
 	int m_op;
+	yy::location m_location; // source position, set by parser
+	NodeProfile* m_profile; // NULL if profiling is disabled
 
 	IASTNode& operator = (const IASTNode& rhs);
 	IASTNode(const IASTNode& rhs);
 public:
-	IASTNode(int operation) : m_op (operation) {}
+	MEMORY_TAG(MEM_AST)
+	IASTNode(int operation) : m_op (operation), m_profile(NULL) {}
 	virtual ~IASTNode() {};
 	int get_op() const { return m_op; }
 	void set_op(int operation) { m_op = operation; }
+	const yy::location& get_location() const { return m_location; }
+	void set_location(const yy::location& location) { m_location = location; }
+	NodeProfile* get_profile() const { return m_profile; }
+	void set_profile(NodeProfile* profile) { m_profile = profile; }
 	virtual void run(InterpreterState&, ExecutionState&) = 0;
 	virtual ISSANode* make_ssa(SSAList& ssa) = 0;
 	virtual void print(int semicolon = 1) = 0;
+	// generic access to children, used by analysis passes
+	virtual int child_count() const { return 0; }
+	virtual IASTNode* get_child(int) const { return NULL; }
+	// replace child, old child isn't deleted
+	virtual void set_child(int, IASTNode*) {}
 };
 
 class ASTEmptyNode : public IASTNode
@@ -71,6 +88,9 @@ public:
 	~ASTUnaryOpNode() { if (m_child != NULL) delete(m_child); }
 	void set(IASTNode* node) { m_child = node; }
 	IASTNode* get() const { return m_child; }
+	int child_count() const { return 1; }
+	IASTNode* get_child(int) const { return m_child; }
+	void set_child(int, IASTNode* node) { m_child = node; }
 	void run(InterpreterState&, ExecutionState&);
 	ISSANode* make_ssa(SSAList& ssa)
 	{
@@ -100,9 +120,10 @@ public:
 class ASTBinaryOpNode : public ASTUnaryOpNode
 {
 	IASTNode* m_child2;
+	int m_fork; // operands can be evaluated in parallel
 
 public:
-	ASTBinaryOpNode(int operation) : ASTUnaryOpNode(operation), m_child2(NULL) {}
+	ASTBinaryOpNode(int operation) : ASTUnaryOpNode(operation), m_child2(NULL), m_fork(0) {}
 	~ASTBinaryOpNode() { if (m_child2 != NULL) delete(m_child2); }
 	void set(IASTNode* node1, IASTNode* node2)
 	{
@@ -115,6 +136,16 @@ public:
 		if (num == 0) return ASTUnaryOpNode::get();
 		else return m_child2;
 	}
+	int child_count() const { return 2; }
+	IASTNode* get_child(int num) const { return get(num); }
+	void set_child(int num, IASTNode* node)
+	{
+		assert(num == 0 || num == 1);
+		if (num == 0) ASTUnaryOpNode::set(node);
+		else m_child2 = node;
+	}
+	int get_fork() const { return m_fork; }
+	void set_fork(int fork) { m_fork = fork; }
 	void run(InterpreterState&, ExecutionState&);
 	ISSANode* make_ssa(SSAList& ssa)
 	{
@@ -165,9 +196,13 @@ public:
 
 class ASTIndexNode : public ASTBinaryOpNode
 {
+	unsigned int m_slot; // array slot in function frame
+
 public:
-	ASTIndexNode() : ASTBinaryOpNode(INDEX) {}
+	ASTIndexNode() : ASTBinaryOpNode(INDEX), m_slot(0) {}
 	~ASTIndexNode() {}
+	unsigned int get_slot() const { return m_slot; }
+	void set_slot(unsigned int slot) { m_slot = slot; }
 	void run(InterpreterState&, ExecutionState&);
 	ISSANode* make_ssa(SSAList& ssa)
 	{
@@ -216,6 +251,9 @@ class ASTTernaryOpNode : public ASTBinaryOpNode
 {
 	IASTNode* m_child3;
 
+protected:
+	// mark last node of ssa, which is condition made from this node, with branch probability
+	void hint_branch(SSAList& ssa) const;
 public:
 	ASTTernaryOpNode(int operation) : ASTBinaryOpNode(operation), m_child3(NULL) {}
 	~ASTTernaryOpNode() { if (m_child3 != NULL) delete(m_child3); }
@@ -230,12 +268,20 @@ public:
 		if (num == 2) return m_child3;
 		else return ASTBinaryOpNode::get(num);
 	}
+	int child_count() const { return 3; }
+	IASTNode* get_child(int num) const { return get(num); }
+	void set_child(int num, IASTNode* node)
+	{
+		assert(num == 0 || num == 1 || num == 2);
+		if (num == 2) m_child3 = node;
+		else ASTBinaryOpNode::set_child(num, node);
+	}
 	void run(InterpreterState&, ExecutionState&);
 	ISSANode* make_ssa(SSAList& ssa)
 	{
 		ISSANode* condition = get(0)->make_ssa(ssa);
-		SSAList* ssa1 = new SSAList;
-		SSAList* ssa2 = new SSAList;
+		SSAList* ssa1 = new SSAList(&ssa);
+		SSAList* ssa2 = new SSAList(&ssa);
 		ISSANode* tern_true = get(1)->make_ssa(*ssa1);
 		ISSANode* tern_false = get(2)->make_ssa(*ssa2);
 		std::string left1_name = ssa.new_name();
@@ -245,6 +291,7 @@ public:
 		ssa1->make_assign(left1, tern_true);
 		ssa2->make_assign(left2, tern_false);
 		ssa.make_ternary(ISSANode::TERNARY, condition, ssa1, ssa2);
+		hint_branch(ssa);
 		SSAPhiNode* phi = new SSAPhiNode;
 		phi->set(ssa.make_var(left1_name));
 		phi->set(ssa.make_var(left2_name));
@@ -273,22 +320,26 @@ public:
 class ASTLeafVar : public IASTNode
 {
 	unsigned int m_id;
+	int m_slot; // array slot in function frame, -1 for variables
 
 public:
-	ASTLeafVar(unsigned int id) : IASTNode(VARIABLE), m_id(id) {}
+	ASTLeafVar(unsigned int id, int slot = -1) : IASTNode(VARIABLE), m_id(id), m_slot(slot) {}
 	~ASTLeafVar() {}
 	unsigned int get() const { return m_id; }
 	void set(unsigned int id) { m_id = id; }
+	int get_slot() const { return m_slot; }
 	void run(InterpreterState& int_st, ExecutionState& exec_st)
 	{
 		if (exec_st.cmd_state == 0) // call to child 1
 		{
-			if (exec_st.variables->count(m_id) == 0) {
+			// frame can be shared by interpreters forked with -j, read it without insertion
+			const VariableMap& variables = *exec_st.variables;
+			VariableMap::const_iterator var = variables.find(m_id);
+			if (var == variables.end()) {
 				if (int_st.sym_table->find(m_id) == int_st.sym_table->end()) calc_unreachable("Variable id not found");
 				calc_unreachable("Variable '" + int_st.sym_table->find(m_id)->second.first + "' not initialized");
 			}
-			double var = (*exec_st.variables)[m_id];
-			int_st.data_stack.push(var);
+			int_st.data_stack.push(var->second);
 			exec_st.cmd_state = int_st.op_stack.top();
 			int_st.op_stack.pop();
 			exec_st.command = int_st.command_stack.top();
@@ -300,16 +351,11 @@ public:
 	}
 	ISSANode* make_ssa(SSAList& ssa)
 	{
-		//TODO
-		calc_unreachable("Not implemented");
-		return NULL;
-		/*
-		char* buf = new char[strlen(m_name.c_str()) + 3];
-		sprintf(buf, "u_%s", m_name.c_str());
-		ISSANode* var = ssa.make_var(buf);
-		delete[] buf;
-		return var;
-		*/
+		const std::map<unsigned int, std::pair<std::string, unsigned int> >* symbols = ssa.context().symbols;
+		if (symbols == NULL) calc_unreachable("Symbol table for SSA not set");
+		std::map<unsigned int, std::pair<std::string, unsigned int> >::const_iterator it = symbols->find(m_id);
+		if (it == symbols->end()) calc_unreachable("Variable id not found");
+		return ssa.make_var("u_" + it->second.first);
 	}
 	virtual void print(int semicolon)
 	{
@@ -332,6 +378,9 @@ public:
 	~ASTIncrOpNode() { if (m_child != NULL) delete(m_child); }
 	void set(IASTNode* node) { m_child = node; }
 	IASTNode* get() const { return m_child; }
+	int child_count() const { return 1; }
+	IASTNode* get_child(int) const { return m_child; }
+	void set_child(int, IASTNode* node) { m_child = node; }
 	void run(InterpreterState&, ExecutionState&);
 	ISSANode* make_ssa(SSAList& ssa)
 	{
@@ -416,6 +465,31 @@ public:
 	}
 };
 
+// declaration of array with init list, values are copied into array at once
+class ASTArrayInitNode : public IASTNode
+{
+	IASTNode* m_array; // ASTLeafVar of array
+	std::vector<double> m_values; // of first elements
+
+public:
+	ASTArrayInitNode(IASTNode* array) : IASTNode(ARRAY_INIT), m_array(array) {}
+	~ASTArrayInitNode() { if (m_array != NULL) delete m_array; }
+	std::vector<double>& values() { return m_values; }
+	int child_count() const { return 1; }
+	IASTNode* get_child(int) const { return m_array; }
+	void set_child(int, IASTNode* node) { m_array = node; }
+	void run(InterpreterState&, ExecutionState&);
+	ISSANode* make_ssa(SSAList&)
+	{
+		if (!m_values.empty()) calc_unreachable("Not implemented"); // arrays aren't compiled
+		return NULL;
+	}
+	void print(int)
+	{
+		calc_unreachable("Not implemented");
+	}
+};
+
 class ASTNoRetBinaryOpNode : public ASTBinaryOpNode
 {
 public:
@@ -464,11 +538,12 @@ public:
 		int op = get_op();
 		if (op == IF) {
 			ISSANode* condition = get(0)->make_ssa(ssa);
-			SSAList* ssa1 = new SSAList;
-			SSAList* ssa2 = new SSAList;
+			SSAList* ssa1 = new SSAList(&ssa);
+			SSAList* ssa2 = new SSAList(&ssa);
 			delete get(1)->make_ssa(*ssa1);
 			delete get(2)->make_ssa(*ssa2);
 			ssa.make_ternary(ISSANode::IF, condition, ssa1, ssa2);
+			hint_branch(ssa);
 		} else {
 			calc_unreachable("Unknown operation");
 		}
@@ -488,6 +563,7 @@ class ASTFuncCallNode : public IASTNode
 public:
 	ASTFuncCallNode(std::string name) : IASTNode(FUNC_CALL), m_name(name)
 	{}
+	const std::string& get_name() const { return m_name; }
 	IASTNode* get_args(int num)
 	{
 		return m_child_args[num];
@@ -495,6 +571,9 @@ public:
 	void set_args(IASTNode* arg) {
 		m_child_args.push_back(arg);
 	}
+	int child_count() const { return m_child_args.size(); }
+	IASTNode* get_child(int num) const { return m_child_args[num]; }
+	void set_child(int num, IASTNode* node) { m_child_args[num] = node; }
 	~ASTFuncCallNode()
 	{
 		std::vector<IASTNode*>::iterator it;
@@ -0,0 +1,252 @@
+#include "Array.h"
+
+unsigned long long ArrayHandle::copies = 0;
+unsigned long long ArrayHandle::copied_bytes = 0;
+unsigned long long ArrayHandle::declared_bytes = 0;
+unsigned long long ArrayHandle::materialized_bytes = 0;
+
+Arena::~Arena()
+{
+	for (unsigned int i = 0; i < m_chunks.size(); i++) {
+		MemoryStats::release(m_chunks[i].data, m_chunks[i].size, MEM_ARRAYS);
+	}
+}
+
+void Arena::next_chunk(size_t size)
+{
+	if (!m_chunks.empty()) {
+		// chunks after current are free, use next one if it is big enough
+		if (m_current + 1 < m_chunks.size() && m_chunks[m_current + 1].size >= size) {
+			m_current++;
+			m_used = 0;
+			return;
+		}
+		m_current++;
+	}
+	Chunk chunk;
+	chunk.size = size > chunk_size ? size : chunk_size;
+	chunk.data = static_cast<char*>(MemoryStats::allocate(chunk.size, MEM_ARRAYS));
+	m_chunks.insert(m_chunks.begin() + m_current, chunk);
+	m_reserved += chunk.size;
+	m_used = 0;
+}
+
+static void* allocate_zero(Arena& arena, size_t size)
+{
+	void* ptr = arena.allocate(size);
+	memset(ptr, 0, size);
+	return ptr;
+}
+
+// low bits of product are zero for index stride 2^k, high bits are mixed by all bits of index
+static unsigned int hash_index(const LargeArray* array, unsigned int ind)
+{
+	return (ind * 2654435761u) >> array->shift;
+}
+
+static double* sparse_find(LargeArray* array, unsigned int ind)
+{
+	unsigned int mask = array->capacity - 1;
+	for (unsigned int h = hash_index(array, ind); array->keys[h] != 0; h = (h + 1) & mask) {
+		if (array->keys[h] == ind + 1) return &array->values[h];
+	}
+	return NULL;
+}
+
+static void sparse_insert(LargeArray* array, unsigned int ind, double value)
+{
+	unsigned int mask = array->capacity - 1;
+	unsigned int h = hash_index(array, ind);
+	while (array->keys[h] != 0) h = (h + 1) & mask;
+	array->keys[h] = ind + 1;
+	array->values[h] = value;
+	array->count++;
+}
+
+static void sparse_resize(LargeArray* array, Arena& arena, unsigned int capacity)
+{
+	unsigned int* keys = array->keys;
+	double* values = array->values;
+	unsigned int old_capacity = array->capacity;
+	array->keys = static_cast<unsigned int*>(allocate_zero(arena, capacity * sizeof(unsigned int)));
+	array->values = static_cast<double*>(arena.allocate(capacity * sizeof(double)));
+	array->capacity = capacity;
+	array->shift = 32;
+	for (unsigned int c = capacity; c > 1; c >>= 1) array->shift--;
+	array->count = 0;
+	__atomic_add_fetch(&ArrayHandle::materialized_bytes, capacity * (sizeof(unsigned int) + sizeof(double)), __ATOMIC_RELAXED);
+	for (unsigned int i = 0; i < old_capacity; i++) {
+		if (keys[i] != 0) sparse_insert(array, keys[i] - 1, values[i]);
+	}
+}
+
+static void page_store(LargeArray* array, Arena& arena, unsigned int ind, double value)
+{
+	double*& page = array->pages[ind / LargeArray::page_size];
+	if (page == NULL) {
+		page = static_cast<double*>(allocate_zero(arena, LargeArray::page_size * sizeof(double)));
+		array->materialized_pages++;
+		__atomic_add_fetch(&ArrayHandle::materialized_bytes, LargeArray::page_size * sizeof(double), __ATOMIC_RELAXED);
+	}
+	page[ind % LargeArray::page_size] = value;
+}
+
+// move elements from hash table to pages
+static void make_paged(LargeArray* array, Arena& arena)
+{
+	array->pages = static_cast<double**>(allocate_zero(arena, array->page_count * sizeof(double*)));
+	__atomic_add_fetch(&ArrayHandle::materialized_bytes, array->page_count * sizeof(double*), __ATOMIC_RELAXED);
+	for (unsigned int i = 0; i < array->capacity; i++) {
+		if (array->keys[i] != 0) page_store(array, arena, array->keys[i] - 1, array->values[i]);
+	}
+	array->keys = NULL;
+	array->values = NULL;
+	array->capacity = 0;
+	array->count = 0;
+}
+
+static LargeArray* new_large_array(Arena& arena, unsigned int length)
+{
+	LargeArray* array = static_cast<LargeArray*>(allocate_zero(arena, sizeof(LargeArray)));
+	array->page_count = (length + LargeArray::page_size - 1) / LargeArray::page_size;
+	array->touched = static_cast<unsigned char*>(allocate_zero(arena, (array->page_count + 7) / 8));
+	sparse_resize(array, arena, 16);
+	return array;
+}
+
+static double large_load(LargeArray* array, unsigned int ind)
+{
+	if (array->pages != NULL) {
+		double* page = array->pages[ind / LargeArray::page_size];
+		return page == NULL ? 0.0 : page[ind % LargeArray::page_size];
+	}
+	double* value = sparse_find(array, ind);
+	return value == NULL ? 0.0 : *value;
+}
+
+static void large_store(LargeArray* array, Arena& arena, unsigned int ind, double value)
+{
+	if (array->pages != NULL) {
+		page_store(array, arena, ind, value);
+		return;
+	}
+	double* old = sparse_find(array, ind);
+	if (old != NULL) {
+		*old = value;
+		return;
+	}
+	if ((array->count + 1) * 2 > array->capacity) sparse_resize(array, arena, array->capacity * 2);
+	sparse_insert(array, ind, value);
+	unsigned int page = ind / LargeArray::page_size;
+	if (!(array->touched[page / 8] & (1 << (page % 8)))) {
+		array->touched[page / 8] |= 1 << (page % 8);
+		array->touched_pages++;
+	}
+	// pages take at most twice more memory than hash table
+	if (array->count >= array->touched_pages * (LargeArray::page_size / 8)) make_paged(array, arena);
+}
+
+static size_t large_copy(LargeArray* array, Arena& arena, LargeArray*& copy)
+{
+	copy = static_cast<LargeArray*>(arena.allocate(sizeof(LargeArray)));
+	*copy = *array;
+	size_t bytes = 0;
+	if (array->pages != NULL) {
+		copy->pages = static_cast<double**>(arena.allocate(array->page_count * sizeof(double*)));
+		for (unsigned int i = 0; i < array->page_count; i++) {
+			copy->pages[i] = NULL;
+			if (array->pages[i] == NULL) continue;
+			copy->pages[i] = static_cast<double*>(arena.allocate(LargeArray::page_size * sizeof(double)));
+			memcpy(copy->pages[i], array->pages[i], LargeArray::page_size * sizeof(double));
+			bytes += LargeArray::page_size * sizeof(double);
+		}
+		__atomic_add_fetch(&ArrayHandle::materialized_bytes, bytes + array->page_count * sizeof(double*), __ATOMIC_RELAXED);
+	} else {
+		size_t touched_size = (array->page_count + 7) / 8;
+		copy->touched = static_cast<unsigned char*>(arena.allocate(touched_size));
+		memcpy(copy->touched, array->touched, touched_size);
+		copy->keys = static_cast<unsigned int*>(arena.allocate(array->capacity * sizeof(unsigned int)));
+		memcpy(copy->keys, array->keys, array->capacity * sizeof(unsigned int));
+		copy->values = static_cast<double*>(arena.allocate(array->capacity * sizeof(double)));
+		memcpy(copy->values, array->values, array->capacity * sizeof(double));
+		bytes = array->capacity * (sizeof(unsigned int) + sizeof(double));
+		__atomic_add_fetch(&ArrayHandle::materialized_bytes, bytes, __ATOMIC_RELAXED);
+	}
+	return bytes;
+}
+
+void ArrayHandle::create_small(Arena& arena)
+{
+	data = static_cast<double*>(allocate_zero(arena, length * sizeof(double)));
+	borrowed = 0;
+	__atomic_add_fetch(&declared_bytes, length * sizeof(double), __ATOMIC_RELAXED);
+	__atomic_add_fetch(&materialized_bytes, length * sizeof(double), __ATOMIC_RELAXED);
+}
+
+void ArrayHandle::copy(Arena& arena)
+{
+	borrowed = 0;
+	if (data == NULL && large == NULL) return; // nothing was written, no copy
+	size_t bytes = 0;
+	if (data != NULL) {
+		double* copy = static_cast<double*>(arena.allocate(length * sizeof(double)));
+		memcpy(copy, data, length * sizeof(double));
+		data = copy;
+		bytes = length * sizeof(double);
+		__atomic_add_fetch(&materialized_bytes, bytes, __ATOMIC_RELAXED);
+	} else if (large != NULL) {
+		bytes = large_copy(large, arena, large);
+	}
+	__atomic_add_fetch(&copies, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&copied_bytes, bytes, __ATOMIC_RELAXED);
+}
+
+double ArrayHandle::load_slow(Arena& arena, unsigned int ind)
+{
+	if (length < large_length) {
+		create_small(arena);
+		return data[ind];
+	}
+	if (large == NULL) return 0.0; // nothing was written
+	return large_load(large, ind);
+}
+
+void ArrayHandle::store_all(Arena& arena, const double* values, unsigned int count)
+{
+	if (borrowed) copy(arena);
+	if (length < large_length) {
+		if (data == NULL) create_small(arena);
+		memcpy(data, values, count * sizeof(double));
+		return;
+	}
+	if (large == NULL) {
+		large = new_large_array(arena, length);
+		__atomic_add_fetch(&declared_bytes, (unsigned long long)length * sizeof(double), __ATOMIC_RELAXED);
+	}
+	// values are dense, pages are used as soon as they would be for single stores
+	if (large->pages == NULL && count >= LargeArray::page_size / 8) make_paged(large, arena);
+	if (large->pages == NULL) {
+		for (unsigned int i = 0; i < count; i++) large_store(large, arena, i, values[i]);
+		return;
+	}
+	for (unsigned int first = 0; first < count; first += LargeArray::page_size) {
+		unsigned int size = count - first < LargeArray::page_size ? count - first : LargeArray::page_size;
+		page_store(large, arena, first, values[first]); // creates page
+		memcpy(large->pages[first / LargeArray::page_size], values + first, size * sizeof(double));
+	}
+}
+
+void ArrayHandle::store_slow(Arena& arena, unsigned int ind, double value)
+{
+	if (borrowed) copy(arena);
+	if (length < large_length) {
+		if (data == NULL) create_small(arena);
+		data[ind] = value;
+		return;
+	}
+	if (large == NULL) {
+		large = new_large_array(arena, length);
+		__atomic_add_fetch(&declared_bytes, (unsigned long long)length * sizeof(double), __ATOMIC_RELAXED);
+	}
+	large_store(large, arena, ind, value);
+}
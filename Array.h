@@ -0,0 +1,120 @@
+#ifndef ARRAY_H
+#define ARRAY_H
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "MemoryStats.h"
+
+// bump allocator for arrays of function frames, memory is released in stack order
+class Arena
+{
+	static const size_t chunk_size = 64 * 1024;
+	struct Chunk
+	{
+		char* data;
+		size_t size;
+	};
+	std::vector<Chunk> m_chunks;
+	unsigned int m_current; // chunk used for allocation
+	size_t m_used; // bytes used in current chunk
+	size_t m_reserved; // bytes in all chunks
+
+	void next_chunk(size_t size);
+
+	Arena(const Arena&);
+	const Arena& operator = (const Arena&);
+public:
+	struct Mark
+	{
+		unsigned int chunk;
+		size_t used;
+	};
+
+	Arena() : m_current(0), m_used(0), m_reserved(0) {}
+	~Arena();
+	void* allocate(size_t size)
+	{
+		size = (size + sizeof(double) - 1) & ~(sizeof(double) - 1);
+		if (m_chunks.empty() || m_chunks[m_current].size - m_used < size) next_chunk(size);
+		void* ptr = m_chunks[m_current].data + m_used;
+		m_used += size;
+		return ptr;
+	}
+	Mark mark() const
+	{
+		Mark m;
+		m.chunk = m_current;
+		m.used = m_used;
+		return m;
+	}
+	// free everything allocated after mark, chunks are kept for next frames
+	void release(const Mark& m)
+	{
+		m_current = m.chunk;
+		m_used = m.used;
+	}
+	size_t reserved() const { return m_reserved; }
+};
+
+// large array, elements are stored in hash table while array is sparse,
+// later in pages of page_size elements, pages are created on first write
+struct LargeArray
+{
+	static const unsigned int page_size = 4096;
+
+	// sparse layout, open addressing, key is index + 1, 0 is empty cell
+	unsigned int* keys;
+	double* values;
+	unsigned int capacity;
+	unsigned int shift; // 32 - log2(capacity), hash is high bits of product
+	unsigned int count;
+	unsigned char* touched; // bitmap of pages having elements in hash table
+	unsigned int touched_pages;
+
+	// paged layout, NULL page is zero page
+	double** pages;
+	unsigned int page_count;
+	unsigned int materialized_pages;
+};
+
+// array of function frame, bound to frame slot at parse time
+// arrays passed to function are borrowed from caller and copied on first write
+struct ArrayHandle
+{
+	static const unsigned int large_length = 64 * 1024; // larger arrays are LargeArray
+
+	double* data; // small array, NULL until first access
+	LargeArray* large; // NULL until first write
+	unsigned int length;
+	int borrowed;
+
+	// counters of all interpreters of process, updated atomically
+	// number and size of copies made on write to borrowed array
+	static unsigned long long copies;
+	static unsigned long long copied_bytes;
+	// size of accessed arrays and memory really used by them
+	static unsigned long long declared_bytes;
+	static unsigned long long materialized_bytes;
+
+	double load(Arena& arena, unsigned int ind)
+	{
+		if (data != NULL) return data[ind];
+		return load_slow(arena, ind);
+	}
+	void store(Arena& arena, unsigned int ind, double value)
+	{
+		if (data != NULL && !borrowed) data[ind] = value;
+		else store_slow(arena, ind, value);
+	}
+	// store values as elements 0..count - 1, count isn't above length
+	void store_all(Arena& arena, const double* values, unsigned int count);
+private:
+	double load_slow(Arena& arena, unsigned int ind);
+	void store_slow(Arena& arena, unsigned int ind, double value);
+	void create_small(Arena& arena);
+	void copy(Arena& arena);
+};
+
+#endif // ARRAY_H
@@ -0,0 +1,83 @@
+#include <sys/time.h>
+#include <fstream>
+#include <cstdio>
+#include <new>
+#include <stdexcept>
+
+#include "Batch.h"
+#include "ParserDriver.h"
+#include "Interpreter.h"
+#include "ThreadPool.h"
+
+class ProgramTask : public Task
+{
+	std::string m_file;
+	std::string m_output;
+	int m_trace;
+public:
+	std::string error; // empty if program succeeded
+
+	ProgramTask(const std::string& file, const std::string& output, int trace)
+		: m_file(file), m_output(output), m_trace(trace) {}
+	void run()
+	{
+		std::ofstream out(m_output.c_str());
+		if (!out) {
+			error = "Cannot open " + m_output;
+			return;
+		}
+		try {
+			ParserDriver driver;
+			if (driver.parse(m_file)) calc_unreachable("Parser error");
+			Interpreter interpreter(&driver.functable, &driver.sym_table);
+			interpreter.set_trace(m_trace ? &out : NULL);
+			interpreter.run();
+		}
+		catch (std::bad_alloc&) {
+			error = "Out of memory";
+		}
+		catch (std::exception& err) {
+			error = err.what();
+		}
+		if (!error.empty()) out << error << std::endl;
+	}
+};
+
+static double now_ms()
+{
+	timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1e3 + tv.tv_usec / 1e3;
+}
+
+std::string Batch::output(const std::string& file) const
+{
+	std::string::size_type slash = file.rfind('/');
+	return m_dir + "/" + (slash == std::string::npos ? file : file.substr(slash + 1)) + ".out";
+}
+
+int Batch::run(ThreadPool& pool, std::ostream& report)
+{
+	MemoryStats::set_shared();
+	double start = now_ms();
+	std::vector<ProgramTask*> tasks;
+	for (unsigned int i = 0; i < m_files.size(); i++) {
+		tasks.push_back(new ProgramTask(m_files[i], output(m_files[i]), m_trace));
+		pool.submit(tasks.back());
+	}
+	int failed = 0;
+	for (unsigned int i = 0; i < tasks.size(); i++) {
+		pool.wait(tasks[i]);
+		if (!tasks[i]->error.empty()) {
+			report << m_files[i] << ": " << tasks[i]->error << "\n";
+			failed++;
+		}
+		delete tasks[i];
+	}
+	double ms = now_ms() - start;
+	char buf[128];
+	sprintf(buf, "%u programs, %d failed, %d threads, %.3f ms, %.1f programs/s\n",
+		static_cast<unsigned int>(m_files.size()), failed, pool.size(), ms, ms > 0.0 ? m_files.size() * 1e3 / ms : 0.0);
+	report << buf;
+	return failed;
+}
@@ -0,0 +1,29 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// runs many programs on thread pool, every program has own driver and interpreter;
+// assignments and error of program are written to <dir>/<file name>.out
+class Batch
+{
+	std::string m_dir;
+	int m_trace;
+	std::vector<std::string> m_files;
+
+	Batch(const Batch&);
+	const Batch& operator = (const Batch&);
+public:
+	Batch(const std::string& dir, int trace) : m_dir(dir), m_trace(trace) {}
+	void add(const std::string& file) { m_files.push_back(file); }
+	// output file of program
+	std::string output(const std::string& file) const;
+	// print failed programs and throughput to report, return number of failed programs
+	int run(ThreadPool& pool, std::ostream& report);
+};
+
+#endif // BATCH_H
@@ -0,0 +1,506 @@
+// microbenchmarks of engine components, built by 'make bench'
+// usage: ./bench [-r repetitions] [-w warmup] [--json] [name_prefix]
+
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "HelpTools.h"
+#include "ParserDriver.h"
+#include "Interpreter.h"
+#include "AbstractSyntaxTree.h"
+#include "SSA.h"
+
+static double now_ns()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// benchmark case measures its own timed region, returns nanoseconds of one sample
+typedef double (*CaseFunc)(int arg);
+
+struct Case
+{
+	std::string name;
+	CaseFunc run;
+	int arg; // passed to run
+	double ops; // operations in one sample
+	const char* unit;
+	const char* baseline; // case which time is subtracted, NULL if none
+};
+
+struct Result
+{
+	double median; // nanoseconds per operation
+	double p95;
+	double min;
+};
+
+// sources are parsed from file, parser reads only files
+static std::string source_file;
+
+static void write_source(const std::string& source, const std::string& name = source_file)
+{
+	FILE* file = fopen(name.c_str(), "w");
+	if (file == NULL || fwrite(source.data(), 1, source.size(), file) != source.size())
+		calc_unreachable("Cannot write benchmark source");
+	fclose(file);
+}
+
+static ParserDriver* parse_source(const std::string& source)
+{
+	write_source(source);
+	ParserDriver* driver = new ParserDriver;
+	if (driver->parse(source_file)) calc_unreachable("Parser error in benchmark source");
+	return driver;
+}
+
+static int count_nodes(IASTNode* node)
+{
+	if (node == NULL) return 0;
+	int count = 1;
+	for (int i = 0; i < node->child_count(); i++) count += count_nodes(node->get_child(i));
+	return count;
+}
+
+// Stack<T>
+
+static const int stack_depth = 1024;
+
+static double bench_stack(int)
+{
+	Stack<double> stack;
+	double start = now_ns();
+	for (int i = 0; i < stack_depth; i++) stack.push(i);
+	while (stack.pop() == 0) {}
+	return now_ns() - start;
+}
+
+// HashTable::get
+
+static const int table_functions = 64;
+static const int table_lookups = 16;
+static HashTable* table = NULL;
+static std::vector<std::string> table_names;
+
+static void make_table()
+{
+	table = new HashTable;
+	for (int i = 0; i < table_functions; i++) {
+		char name[32];
+		sprintf(name, "func_%d", i);
+		ParserFunc* pf = new ParserFunc;
+		pf->name = name;
+		table->put(pf);
+		table_names.push_back(name);
+	}
+}
+
+static double bench_hashtable_get(int)
+{
+	volatile int found = 0;
+	double start = now_ns();
+	for (int n = 0; n < table_lookups; n++) {
+		for (int i = 0; i < table_functions; i++) {
+			if (table->get(table_names[i]) != NULL) found++;
+		}
+	}
+	double time = now_ns() - start;
+	if (found != table_functions * table_lookups) calc_unreachable("Function lost in hash table");
+	return time;
+}
+
+// scanner and parser, AST teardown
+
+static const int parse_functions = 200;
+static std::string parse_source_text;
+static int parse_nodes = 0;
+
+static std::string make_parse_source()
+{
+	std::ostringstream out;
+	for (int f = 0; f < parse_functions; f++) {
+		out << "function f" << f << "(a, b)\n{\n";
+		out << "\tx = a * 2.5 + b;\n\ty = (x - a) / (b + 1.0);\n\ti = 0;\n\tv[8];\n";
+		out << "\twhile (i < 8) {\n\t\tv[i] = x > y ? x : -y;\n\t\ti++;\n\t}\n";
+		out << "\tif (x == y) {\n\t\tx = !x;\n\t} else {\n\t\ty = v[3] + v[4];\n\t}\n";
+		out << "\tresult = x + y;\n}\n\n";
+	}
+	out << "function main()\n{\n\tresult = f0(1.0, 2.0);\n}\n";
+	return out.str();
+}
+
+static double bench_parse(int)
+{
+	ParserDriver* driver = new ParserDriver;
+	double start = now_ns();
+	if (driver->parse(source_file)) calc_unreachable("Parser error in benchmark source");
+	double time = now_ns() - start;
+	delete driver;
+	return time;
+}
+
+// multi-megabyte source, every statement looks up names declared in enclosing scopes
+static const int scope_functions = 400;
+static const int scope_locals = 24;
+static const int scope_depth = 6;
+static std::string scope_source_file;
+static size_t scope_source_size = 0;
+
+static std::string make_scope_source()
+{
+	std::ostringstream out;
+	for (int f = 0; f < scope_functions; f++) {
+		out << "function scope" << f << "(first_argument, second_argument)\n{\n";
+		for (int v = 0; v < scope_locals; v++) out << "\tlocal_variable_" << v << " = first_argument * " << v << ";\n";
+		for (int d = 0; d < scope_depth; d++) {
+			std::string indent(d + 1, '\t');
+			out << indent << "if (second_argument > " << d << ") {\n";
+			out << indent << "\tnested_counter_" << d << " = " << d << ";\n";
+			for (int v = 0; v < scope_locals; v++) {
+				out << indent << "\tlocal_variable_" << v << " = local_variable_" << (v + 1) % scope_locals;
+				out << " + nested_counter_" << d << " * first_argument;\n";
+			}
+		}
+		for (int d = scope_depth - 1; d >= 0; d--) out << std::string(d + 1, '\t') << "}\n";
+		out << "\tresult = local_variable_0;\n}\n\n";
+	}
+	out << "function main()\n{\n\tresult = scope0(1.0, 2.0);\n}\n";
+	return out.str();
+}
+
+static double bench_parse_scopes(int)
+{
+	ParserDriver* driver = new ParserDriver;
+	double start = now_ns();
+	if (driver->parse(scope_source_file)) calc_unreachable("Parser error in benchmark source");
+	double time = now_ns() - start;
+	delete driver;
+	return time;
+}
+
+// tokens of scope source, arg is -1 for flex scanner or SIMD level of fast scanner
+static double bench_scan(int simd)
+{
+	ParserDriver driver;
+	driver.fast_scanning = simd >= 0;
+	if (simd >= 0) driver.fast_scanner.set_simd(simd);
+	double start = now_ns();
+	driver.tokens(scope_source_file, NULL);
+	return now_ns() - start;
+}
+
+static double bench_ast_teardown(int)
+{
+	ParserDriver* driver = new ParserDriver;
+	if (driver->parse(source_file)) calc_unreachable("Parser error in benchmark source");
+	double start = now_ns();
+	delete driver;
+	return now_ns() - start;
+}
+
+// SSA build and renaming of generated straight line code
+
+static const int ssa_statements = 2000;
+static const int ssa_variables = 16;
+
+static void build_ssa(SSAList& ssa)
+{
+	char name[16], left[16], right[16];
+	for (int i = 0; i < ssa_statements; i++) {
+		sprintf(name, "v%d", i % ssa_variables);
+		sprintf(left, "v%d", (i + 3) % ssa_variables);
+		sprintf(right, "v%d", (i + 7) % ssa_variables);
+		if (i % 3 == 0) ssa.make_assign(ssa.make_var(name), ssa.make_num(i));
+		else ssa.make_binary(i % 2 ? ISSANode::ADD : ISSANode::MUL, ssa.make_var(name), ssa.make_var(left), ssa.make_var(right));
+	}
+}
+
+static double bench_ssa_build(int)
+{
+	SSAList ssa;
+	double start = now_ns();
+	build_ssa(ssa);
+	return now_ns() - start;
+}
+
+static double bench_ssa_rename(int)
+{
+	SSAList ssa;
+	build_ssa(ssa);
+	std::map<std::string, int> in;
+	std::map<std::string, int> out;
+	double start = now_ns();
+	ssa.make_ssa(in, out);
+	return now_ns() - start;
+}
+
+// interpreter dispatch, every program runs one statement in a loop,
+// time of loop without statement is subtracted
+
+static const int dispatch_iterations = 20000;
+
+struct DispatchProgram
+{
+	const char* name;
+	const char* statement;
+};
+
+static const DispatchProgram dispatch_programs[] = {
+	{ "loop", "" },
+	{ "number", "x = 1.0;" },
+	{ "variable", "x = y;" },
+	{ "add", "x = y + z;" },
+	{ "mul", "x = y * z;" },
+	{ "less", "x = y < z;" },
+	{ "not", "x = !y;" },
+	{ "unary_minus", "x = -y;" },
+	{ "ternary", "x = y ? z : y;" },
+	{ "if", "if (y) { x = z; }" },
+	{ "increment", "x++;" },
+	{ "index_load", "x = a[1];" },
+	{ "index_store", "a[1] = y;" },
+	{ "call", "x = g(y);" }
+};
+
+static const int dispatch_count = sizeof(dispatch_programs) / sizeof(dispatch_programs[0]);
+static ParserDriver* dispatch_drivers[dispatch_count];
+
+static std::string make_dispatch_source(const char* statement)
+{
+	std::ostringstream out;
+	out << "function g(n)\n{\n\tresult = n;\n}\n\n";
+	out << "function main()\n{\n\ti = 0;\n\tx = 0.0;\n\ty = 1.0;\n\tz = 2.0;\n\ta[4];\n";
+	out << "\twhile (i < " << dispatch_iterations << ") {\n\t\t" << statement << "\n\t\ti++;\n\t}\n";
+	out << "\tresult = x;\n}\n";
+	return out.str();
+}
+
+static double bench_dispatch(int program)
+{
+	ParserDriver* driver = dispatch_drivers[program];
+	Interpreter interpreter(&driver->functable, &driver->sym_table);
+	interpreter.set_trace(NULL);
+	double start = now_ns();
+	interpreter.run();
+	return now_ns() - start;
+}
+
+// large table given by init list, parsed and stored in array
+
+static const int init_list_length = 100000;
+static std::string init_list_source_file;
+static ParserDriver* init_list_driver = NULL;
+
+static std::string make_init_list_source()
+{
+	std::ostringstream out;
+	out << "function main()\n{\n\ttable[" << init_list_length << "] = [";
+	for (int i = 0; i < init_list_length; i++) out << (i == 0 ? "" : ", ") << (i * 7919 % 1000) << "." << i % 100;
+	out << "];\n\tresult = table[" << init_list_length - 1 << "];\n}\n";
+	return out.str();
+}
+
+static double bench_init_list_parse(int)
+{
+	ParserDriver* driver = new ParserDriver;
+	double start = now_ns();
+	if (driver->parse(init_list_source_file)) calc_unreachable("Parser error in benchmark source");
+	double time = now_ns() - start;
+	delete driver;
+	return time;
+}
+
+static double bench_init_list_run(int)
+{
+	Interpreter interpreter(&init_list_driver->functable, &init_list_driver->sym_table);
+	interpreter.set_trace(NULL);
+	double start = now_ns();
+	interpreter.run();
+	return now_ns() - start;
+}
+
+static void make_cases(std::vector<Case>& cases)
+{
+	make_table();
+	parse_source_text = make_parse_source();
+	ParserDriver* driver = parse_source(parse_source_text);
+	std::vector<ParserFunc*> funcs;
+	driver->functable.get_all(funcs);
+	for (unsigned int i = 0; i < funcs.size(); i++) {
+		parse_nodes += count_nodes(funcs[i]->body);
+		for (unsigned int j = 0; j < funcs[i]->arg.size(); j++) parse_nodes += count_nodes(funcs[i]->arg[j]);
+	}
+	delete driver;
+	std::string scope_source = make_scope_source();
+	scope_source_size = scope_source.size();
+	write_source(scope_source, scope_source_file);
+
+	Case c;
+	c.arg = 0;
+	c.baseline = NULL;
+	c.name = "stack_push_pop"; c.run = bench_stack; c.ops = 2 * stack_depth; c.unit = "op";
+	cases.push_back(c);
+	c.name = "hashtable_get"; c.run = bench_hashtable_get; c.ops = table_functions * table_lookups; c.unit = "lookup";
+	cases.push_back(c);
+	c.name = "parse"; c.run = bench_parse; c.ops = parse_source_text.size(); c.unit = "byte";
+	cases.push_back(c);
+	c.name = "parse_scopes"; c.run = bench_parse_scopes; c.ops = scope_source_size; c.unit = "byte";
+	cases.push_back(c);
+	c.name = "scan_flex"; c.run = bench_scan; c.arg = -1; c.ops = scope_source_size; c.unit = "byte";
+	cases.push_back(c);
+	for (int simd = FastScanner::SCALAR; simd <= FastScanner::best_simd(); simd++) {
+		c.name = std::string("scan_") + FastScanner::simd_name(simd);
+		c.arg = simd;
+		cases.push_back(c);
+	}
+	c.arg = 0;
+	c.name = "ast_teardown"; c.run = bench_ast_teardown; c.ops = parse_nodes; c.unit = "node";
+	cases.push_back(c);
+	c.name = "ssa_build"; c.run = bench_ssa_build; c.ops = ssa_statements; c.unit = "statement";
+	cases.push_back(c);
+	c.name = "ssa_rename"; c.run = bench_ssa_rename; c.ops = ssa_statements; c.unit = "statement";
+	cases.push_back(c);
+
+	for (int i = 0; i < dispatch_count; i++) {
+		dispatch_drivers[i] = parse_source(make_dispatch_source(dispatch_programs[i].statement));
+		c.name = std::string("dispatch_") + dispatch_programs[i].name;
+		c.run = bench_dispatch;
+		c.arg = i;
+		c.ops = dispatch_iterations;
+		c.unit = "iteration";
+		c.baseline = i == 0 ? NULL : "dispatch_loop";
+		cases.push_back(c);
+	}
+
+	write_source(make_init_list_source(), init_list_source_file);
+	init_list_driver = new ParserDriver;
+	if (init_list_driver->parse(init_list_source_file)) calc_unreachable("Parser error in benchmark source");
+	c.arg = 0;
+	c.baseline = NULL;
+	c.ops = init_list_length;
+	c.unit = "element";
+	c.name = "init_list_parse"; c.run = bench_init_list_parse;
+	cases.push_back(c);
+	c.name = "init_list_run"; c.run = bench_init_list_run;
+	cases.push_back(c);
+	write_source(parse_source_text); // read by parse benchmarks
+}
+
+// sorted samples in nanoseconds per operation
+static Result summarize(std::vector<double>& samples)
+{
+	std::sort(samples.begin(), samples.end());
+	Result res;
+	res.min = samples[0];
+	res.median = samples[samples.size() / 2];
+	unsigned int p95 = (samples.size() * 95 + 99) / 100;
+	res.p95 = samples[p95 == 0 ? 0 : p95 - 1];
+	return res;
+}
+
+static void usage()
+{
+	std::cout << "Usage: ./bench [options] [name_prefix]\n";
+	std::cout << "options:\n";
+	std::cout << "\t-r count\tmeasured repetitions of every case (default 30)\n";
+	std::cout << "\t-w count\twarm-up repetitions (default 5)\n";
+	std::cout << "\t--json\t\tprint results as JSON\n";
+	exit(-1);
+}
+
+int main(int argc, char** argv)
+{
+	int repetitions = 30;
+	int warmup = 5;
+	int json = 0;
+	std::string filter;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+			repetitions = atoi(argv[++i]);
+			if (repetitions <= 0) usage();
+		} else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+			warmup = atoi(argv[++i]);
+			if (warmup < 0) usage();
+		} else if (strcmp(argv[i], "--json") == 0) {
+			json = 1;
+		} else if (argv[i][0] != '-' && filter.empty()) {
+			filter = argv[i];
+		} else {
+			usage();
+		}
+	}
+
+	char file_name[] = "/tmp/calc_bench_XXXXXX";
+	int fd = mkstemp(file_name);
+	if (fd < 0) {
+		std::cerr << "Cannot create temporary file\n";
+		return -1;
+	}
+	close(fd);
+	source_file = file_name;
+	scope_source_file = source_file + ".scopes";
+	init_list_source_file = source_file + ".init";
+
+	std::vector<Case> cases;
+	std::map<std::string, Result> results;
+	try {
+		make_cases(cases);
+		if (json) std::cout << "{\"repetitions\": " << repetitions << ", \"warmup\": " << warmup << ", \"results\": [";
+		else printf("%-24s %12s %12s %12s  %s\n", "case", "median ns", "p95 ns", "min ns", "per");
+		int first = 1;
+		for (unsigned int i = 0; i < cases.size(); i++) {
+			const Case& c = cases[i];
+			// baselines always run, their results are needed by other cases
+			int baseline_needed = 0;
+			for (unsigned int j = i + 1; j < cases.size(); j++) {
+				if (cases[j].baseline != NULL && c.name == cases[j].baseline && cases[j].name.compare(0, filter.size(), filter) == 0) baseline_needed = 1;
+			}
+			int selected = c.name.compare(0, filter.size(), filter) == 0;
+			if (!selected && !baseline_needed) continue;
+
+			for (int n = 0; n < warmup; n++) c.run(c.arg);
+			std::vector<double> samples;
+			for (int n = 0; n < repetitions; n++) samples.push_back(c.run(c.arg) / c.ops);
+			if (c.baseline != NULL) {
+				double base = results[c.baseline].median;
+				for (unsigned int n = 0; n < samples.size(); n++) samples[n] -= base;
+			}
+			Result res = summarize(samples);
+			results[c.name] = res;
+			if (!selected) continue;
+
+			if (json) {
+				printf("%s\n  {\"name\": \"%s\", \"unit\": \"%s\", \"median_ns\": %.3f, \"p95_ns\": %.3f, \"min_ns\": %.3f, \"ops\": %.0f}",
+					first ? "" : ",", c.name.c_str(), c.unit, res.median, res.p95, res.min, c.ops);
+				first = 0;
+			} else {
+				printf("%-24s %12.3f %12.3f %12.3f  %s\n", c.name.c_str(), res.median, res.p95, res.min, c.unit);
+			}
+		}
+		if (json) printf("\n]}\n");
+	}
+	catch (std::logic_error& err) {
+		std::cerr << err.what() << std::endl;
+		unlink(file_name);
+		unlink(scope_source_file.c_str());
+		unlink(init_list_source_file.c_str());
+		return -1;
+	}
+	for (int i = 0; i < dispatch_count; i++) delete dispatch_drivers[i];
+	delete init_list_driver;
+	delete table;
+	unlink(file_name);
+	unlink(scope_source_file.c_str());
+	unlink(init_list_source_file.c_str());
+	return 0;
+}
@@ -0,0 +1,2034 @@
+// A Bison parser, made by GNU Bison 3.8.2.
+
+// Skeleton implementation for Bison LALR(1) parsers in C++
+
+// Copyright (C) 2002-2015, 2018-2021 Free Software Foundation, Inc.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// As a special exception, you may create a larger work that contains
+// part or all of the Bison parser skeleton and distribute that work
+// under terms of your choice, so long as that work isn't itself a
+// parser generator using the skeleton or a modified version thereof
+// as a parser skeleton.  Alternatively, if you modify or redistribute
+// the parser skeleton itself, you may (at your option) remove this
+// special exception, which will cause the skeleton and the resulting
+// Bison output files to be licensed under the GNU General Public
+// License without this special exception.
+
+// This special exception was added by the Free Software Foundation in
+// version 2.2 of Bison.
+
+// DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+// especially those whose name start with YY_ or yy_.  They are
+// private implementation details that can be changed or removed.
+
+
+
+
+
+#include "CalcParser.tab.hh"
+
+
+// Unqualified %code blocks.
+#line 32 "CalcParser.yy"
+
+#include "ParserDriver.h"
+
+#line 50 "CalcParser.tab.cc"
+
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> // FIXME: INFRINGES ON USER NAME SPACE.
+#   define YY_(msgid) dgettext ("bison-runtime", msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(msgid) msgid
+# endif
+#endif
+
+
+// Whether we are compiled with exception support.
+#ifndef YY_EXCEPTIONS
+# if defined __GNUC__ && !defined __EXCEPTIONS
+#  define YY_EXCEPTIONS 0
+# else
+#  define YY_EXCEPTIONS 1
+# endif
+#endif
+
+#define YYRHSLOC(Rhs, K) ((Rhs)[K].location)
+/* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
+   If N is 0, then set CURRENT to the empty location which ends
+   the previous symbol: RHS[0] (always defined).  */
+
+# ifndef YYLLOC_DEFAULT
+#  define YYLLOC_DEFAULT(Current, Rhs, N)                               \
+    do                                                                  \
+      if (N)                                                            \
+        {                                                               \
+          (Current).begin  = YYRHSLOC (Rhs, 1).begin;                   \
+          (Current).end    = YYRHSLOC (Rhs, N).end;                     \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          (Current).begin = (Current).end = YYRHSLOC (Rhs, 0).end;      \
+        }                                                               \
+    while (false)
+# endif
+
+
+// Enable debugging if requested.
+#if YYDEBUG
+
+// A pseudo ostream that takes yydebug_ into account.
+# define YYCDEBUG if (yydebug_) (*yycdebug_)
+
+# define YY_SYMBOL_PRINT(Title, Symbol)         \
+  do {                                          \
+    if (yydebug_)                               \
+    {                                           \
+      *yycdebug_ << Title << ' ';               \
+      yy_print_ (*yycdebug_, Symbol);           \
+      *yycdebug_ << '\n';                       \
+    }                                           \
+  } while (false)
+
+# define YY_REDUCE_PRINT(Rule)          \
+  do {                                  \
+    if (yydebug_)                       \
+      yy_reduce_print_ (Rule);          \
+  } while (false)
+
+# define YY_STACK_PRINT()               \
+  do {                                  \
+    if (yydebug_)                       \
+      yy_stack_print_ ();                \
+  } while (false)
+
+#else // !YYDEBUG
+
+# define YYCDEBUG if (false) std::cerr
+# define YY_SYMBOL_PRINT(Title, Symbol)  YY_USE (Symbol)
+# define YY_REDUCE_PRINT(Rule)           static_cast<void> (0)
+# define YY_STACK_PRINT()                static_cast<void> (0)
+
+#endif // !YYDEBUG
+
+#define yyerrok         (yyerrstatus_ = 0)
+#define yyclearin       (yyla.clear ())
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYRECOVERING()  (!!yyerrstatus_)
+
+namespace yy {
+#line 142 "CalcParser.tab.cc"
+
+  /// Build a parser object.
+  CalcParser::CalcParser (ParserDriver& driver_yyarg)
+#if YYDEBUG
+    : yydebug_ (false),
+      yycdebug_ (&std::cerr),
+#else
+    :
+#endif
+      driver (driver_yyarg)
+  {}
+
+  CalcParser::~CalcParser ()
+  {}
+
+  CalcParser::syntax_error::~syntax_error () YY_NOEXCEPT YY_NOTHROW
+  {}
+
+  /*---------.
+  | symbol.  |
+  `---------*/
+
+
+
+  // by_state.
+  CalcParser::by_state::by_state () YY_NOEXCEPT
+    : state (empty_state)
+  {}
+
+  CalcParser::by_state::by_state (const by_state& that) YY_NOEXCEPT
+    : state (that.state)
+  {}
+
+  void
+  CalcParser::by_state::clear () YY_NOEXCEPT
+  {
+    state = empty_state;
+  }
+
+  void
+  CalcParser::by_state::move (by_state& that)
+  {
+    state = that.state;
+    that.clear ();
+  }
+
+  CalcParser::by_state::by_state (state_type s) YY_NOEXCEPT
+    : state (s)
+  {}
+
+  CalcParser::symbol_kind_type
+  CalcParser::by_state::kind () const YY_NOEXCEPT
+  {
+    if (state == empty_state)
+      return symbol_kind::S_YYEMPTY;
+    else
+      return YY_CAST (symbol_kind_type, yystos_[+state]);
+  }
+
+  CalcParser::stack_symbol_type::stack_symbol_type ()
+  {}
+
+  CalcParser::stack_symbol_type::stack_symbol_type (YY_RVREF (stack_symbol_type) that)
+    : super_type (YY_MOVE (that.state), YY_MOVE (that.location))
+  {
+    switch (that.kind ())
+    {
+      case symbol_kind::S_statements: // statements
+      case symbol_kind::S_block: // block
+      case symbol_kind::S_statement: // statement
+      case symbol_kind::S_initialization: // initialization
+      case symbol_kind::S_inc_dec: // inc_dec
+      case symbol_kind::S_any_expr: // any_expr
+      case symbol_kind::S_assign: // assign
+      case symbol_kind::S_ternary: // ternary
+      case symbol_kind::S_equality: // equality
+      case symbol_kind::S_comparison: // comparison
+      case symbol_kind::S_expr: // expr
+      case symbol_kind::S_term: // term
+      case symbol_kind::S_prim: // prim
+      case symbol_kind::S_modifiable: // modifiable
+      case symbol_kind::S_def_modifiable: // def_modifiable
+        value.YY_MOVE_OR_COPY< IASTNode* > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_NUMBER: // "number"
+        value.YY_MOVE_OR_COPY< double > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_func_def_args: // func_def_args
+      case symbol_kind::S_func_call_args: // func_call_args
+        value.YY_MOVE_OR_COPY< std::list<IASTNode*>* > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_init_list: // init_list
+        value.YY_MOVE_OR_COPY< std::vector<double>* > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_NAME: // "name"
+        value.YY_MOVE_OR_COPY< unsigned int > (YY_MOVE (that.value));
+        break;
+
+      default:
+        break;
+    }
+
+#if 201103L <= YY_CPLUSPLUS
+    // that is emptied.
+    that.state = empty_state;
+#endif
+  }
+
+  CalcParser::stack_symbol_type::stack_symbol_type (state_type s, YY_MOVE_REF (symbol_type) that)
+    : super_type (s, YY_MOVE (that.location))
+  {
+    switch (that.kind ())
+    {
+      case symbol_kind::S_statements: // statements
+      case symbol_kind::S_block: // block
+      case symbol_kind::S_statement: // statement
+      case symbol_kind::S_initialization: // initialization
+      case symbol_kind::S_inc_dec: // inc_dec
+      case symbol_kind::S_any_expr: // any_expr
+      case symbol_kind::S_assign: // assign
+      case symbol_kind::S_ternary: // ternary
+      case symbol_kind::S_equality: // equality
+      case symbol_kind::S_comparison: // comparison
+      case symbol_kind::S_expr: // expr
+      case symbol_kind::S_term: // term
+      case symbol_kind::S_prim: // prim
+      case symbol_kind::S_modifiable: // modifiable
+      case symbol_kind::S_def_modifiable: // def_modifiable
+        value.move< IASTNode* > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_NUMBER: // "number"
+        value.move< double > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_func_def_args: // func_def_args
+      case symbol_kind::S_func_call_args: // func_call_args
+        value.move< std::list<IASTNode*>* > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_init_list: // init_list
+        value.move< std::vector<double>* > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_NAME: // "name"
+        value.move< unsigned int > (YY_MOVE (that.value));
+        break;
+
+      default:
+        break;
+    }
+
+    // that is emptied.
+    that.kind_ = symbol_kind::S_YYEMPTY;
+  }
+
+#if YY_CPLUSPLUS < 201103L
+  CalcParser::stack_symbol_type&
+  CalcParser::stack_symbol_type::operator= (const stack_symbol_type& that)
+  {
+    state = that.state;
+    switch (that.kind ())
+    {
+      case symbol_kind::S_statements: // statements
+      case symbol_kind::S_block: // block
+      case symbol_kind::S_statement: // statement
+      case symbol_kind::S_initialization: // initialization
+      case symbol_kind::S_inc_dec: // inc_dec
+      case symbol_kind::S_any_expr: // any_expr
+      case symbol_kind::S_assign: // assign
+      case symbol_kind::S_ternary: // ternary
+      case symbol_kind::S_equality: // equality
+      case symbol_kind::S_comparison: // comparison
+      case symbol_kind::S_expr: // expr
+      case symbol_kind::S_term: // term
+      case symbol_kind::S_prim: // prim
+      case symbol_kind::S_modifiable: // modifiable
+      case symbol_kind::S_def_modifiable: // def_modifiable
+        value.copy< IASTNode* > (that.value);
+        break;
+
+      case symbol_kind::S_NUMBER: // "number"
+        value.copy< double > (that.value);
+        break;
+
+      case symbol_kind::S_func_def_args: // func_def_args
+      case symbol_kind::S_func_call_args: // func_call_args
+        value.copy< std::list<IASTNode*>* > (that.value);
+        break;
+
+      case symbol_kind::S_init_list: // init_list
+        value.copy< std::vector<double>* > (that.value);
+        break;
+
+      case symbol_kind::S_NAME: // "name"
+        value.copy< unsigned int > (that.value);
+        break;
+
+      default:
+        break;
+    }
+
+    location = that.location;
+    return *this;
+  }
+
+  CalcParser::stack_symbol_type&
+  CalcParser::stack_symbol_type::operator= (stack_symbol_type& that)
+  {
+    state = that.state;
+    switch (that.kind ())
+    {
+      case symbol_kind::S_statements: // statements
+      case symbol_kind::S_block: // block
+      case symbol_kind::S_statement: // statement
+      case symbol_kind::S_initialization: // initialization
+      case symbol_kind::S_inc_dec: // inc_dec
+      case symbol_kind::S_any_expr: // any_expr
+      case symbol_kind::S_assign: // assign
+      case symbol_kind::S_ternary: // ternary
+      case symbol_kind::S_equality: // equality
+      case symbol_kind::S_comparison: // comparison
+      case symbol_kind::S_expr: // expr
+      case symbol_kind::S_term: // term
+      case symbol_kind::S_prim: // prim
+      case symbol_kind::S_modifiable: // modifiable
+      case symbol_kind::S_def_modifiable: // def_modifiable
+        value.move< IASTNode* > (that.value);
+        break;
+
+      case symbol_kind::S_NUMBER: // "number"
+        value.move< double > (that.value);
+        break;
+
+      case symbol_kind::S_func_def_args: // func_def_args
+      case symbol_kind::S_func_call_args: // func_call_args
+        value.move< std::list<IASTNode*>* > (that.value);
+        break;
+
+      case symbol_kind::S_init_list: // init_list
+        value.move< std::vector<double>* > (that.value);
+        break;
+
+      case symbol_kind::S_NAME: // "name"
+        value.move< unsigned int > (that.value);
+        break;
+
+      default:
+        break;
+    }
+
+    location = that.location;
+    // that is emptied.
+    that.state = empty_state;
+    return *this;
+  }
+#endif
+
+  template <typename Base>
+  void
+  CalcParser::yy_destroy_ (const char* yymsg, basic_symbol<Base>& yysym) const
+  {
+    if (yymsg)
+      YY_SYMBOL_PRINT (yymsg, yysym);
+  }
+
+#if YYDEBUG
+  template <typename Base>
+  void
+  CalcParser::yy_print_ (std::ostream& yyo, const basic_symbol<Base>& yysym) const
+  {
+    std::ostream& yyoutput = yyo;
+    YY_USE (yyoutput);
+    if (yysym.empty ())
+      yyo << "empty symbol";
+    else
+      {
+        symbol_kind_type yykind = yysym.kind ();
+        yyo << (yykind < YYNTOKENS ? "token" : "nterm")
+            << ' ' << yysym.name () << " ("
+            << yysym.location << ": ";
+        switch (yykind)
+    {
+      case symbol_kind::S_NAME: // "name"
+#line 77 "CalcParser.yy"
+                 { yyoutput << driver.names.name(yysym.value.template as < unsigned int > ()); }
+#line 433 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_NUMBER: // "number"
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < double > (); }
+#line 439 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_statements: // statements
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < IASTNode* > (); }
+#line 445 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_block: // block
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < IASTNode* > (); }
+#line 451 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_statement: // statement
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < IASTNode* > (); }
+#line 457 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_initialization: // initialization
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < IASTNode* > (); }
+#line 463 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_inc_dec: // inc_dec
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < IASTNode* > (); }
+#line 469 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_any_expr: // any_expr
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < IASTNode* > (); }
+#line 475 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_assign: // assign
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < IASTNode* > (); }
+#line 481 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_ternary: // ternary
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < IASTNode* > (); }
+#line 487 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_equality: // equality
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < IASTNode* > (); }
+#line 493 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_comparison: // comparison
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < IASTNode* > (); }
+#line 499 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_expr: // expr
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < IASTNode* > (); }
+#line 505 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_term: // term
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < IASTNode* > (); }
+#line 511 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_prim: // prim
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < IASTNode* > (); }
+#line 517 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_modifiable: // modifiable
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < IASTNode* > (); }
+#line 523 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_init_list: // init_list
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < std::vector<double>* > (); }
+#line 529 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_func_def_args: // func_def_args
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < std::list<IASTNode*>* > (); }
+#line 535 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_def_modifiable: // def_modifiable
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < IASTNode* > (); }
+#line 541 "CalcParser.tab.cc"
+        break;
+
+      case symbol_kind::S_func_call_args: // func_call_args
+#line 78 "CalcParser.yy"
+                 { yyoutput << yysym.value.template as < std::list<IASTNode*>* > (); }
+#line 547 "CalcParser.tab.cc"
+        break;
+
+      default:
+        break;
+    }
+        yyo << ')';
+      }
+  }
+#endif
+
+  void
+  CalcParser::yypush_ (const char* m, YY_MOVE_REF (stack_symbol_type) sym)
+  {
+    if (m)
+      YY_SYMBOL_PRINT (m, sym);
+    yystack_.push (YY_MOVE (sym));
+  }
+
+  void
+  CalcParser::yypush_ (const char* m, state_type s, YY_MOVE_REF (symbol_type) sym)
+  {
+#if 201103L <= YY_CPLUSPLUS
+    yypush_ (m, stack_symbol_type (s, std::move (sym)));
+#else
+    stack_symbol_type ss (s, sym);
+    yypush_ (m, ss);
+#endif
+  }
+
+  void
+  CalcParser::yypop_ (int n) YY_NOEXCEPT
+  {
+    yystack_.pop (n);
+  }
+
+#if YYDEBUG
+  std::ostream&
+  CalcParser::debug_stream () const
+  {
+    return *yycdebug_;
+  }
+
+  void
+  CalcParser::set_debug_stream (std::ostream& o)
+  {
+    yycdebug_ = &o;
+  }
+
+
+  CalcParser::debug_level_type
+  CalcParser::debug_level () const
+  {
+    return yydebug_;
+  }
+
+  void
+  CalcParser::set_debug_level (debug_level_type l)
+  {
+    yydebug_ = l;
+  }
+#endif // YYDEBUG
+
+  CalcParser::state_type
+  CalcParser::yy_lr_goto_state_ (state_type yystate, int yysym)
+  {
+    int yyr = yypgoto_[yysym - YYNTOKENS] + yystate;
+    if (0 <= yyr && yyr <= yylast_ && yycheck_[yyr] == yystate)
+      return yytable_[yyr];
+    else
+      return yydefgoto_[yysym - YYNTOKENS];
+  }
+
+  bool
+  CalcParser::yy_pact_value_is_default_ (int yyvalue) YY_NOEXCEPT
+  {
+    return yyvalue == yypact_ninf_;
+  }
+
+  bool
+  CalcParser::yy_table_value_is_error_ (int yyvalue) YY_NOEXCEPT
+  {
+    return yyvalue == yytable_ninf_;
+  }
+
+  int
+  CalcParser::operator() ()
+  {
+    return parse ();
+  }
+
+  int
+  CalcParser::parse ()
+  {
+    int yyn;
+    /// Length of the RHS of the rule being reduced.
+    int yylen = 0;
+
+    // Error handling.
+    int yynerrs_ = 0;
+    int yyerrstatus_ = 0;
+
+    /// The lookahead symbol.
+    symbol_type yyla;
+
+    /// The locations where the error started and ended.
+    stack_symbol_type yyerror_range[3];
+
+    /// The return value of parse ().
+    int yyresult;
+
+#if YY_EXCEPTIONS
+    try
+#endif // YY_EXCEPTIONS
+      {
+    YYCDEBUG << "Starting parse\n";
+
+
+    // User initialization code.
+#line 24 "CalcParser.yy"
+{
+	yyla.location.begin.filename = yyla.location.end.filename = &driver.file;
+}
+
+#line 671 "CalcParser.tab.cc"
+
+
+    /* Initialize the stack.  The initial state will be set in
+       yynewstate, since the latter expects the semantical and the
+       location values to have been already stored, initialize these
+       stacks with a primary value.  */
+    yystack_.clear ();
+    yypush_ (YY_NULLPTR, 0, YY_MOVE (yyla));
+
+  /*-----------------------------------------------.
+  | yynewstate -- push a new symbol on the stack.  |
+  `-----------------------------------------------*/
+  yynewstate:
+    YYCDEBUG << "Entering state " << int (yystack_[0].state) << '\n';
+    YY_STACK_PRINT ();
+
+    // Accept?
+    if (yystack_[0].state == yyfinal_)
+      YYACCEPT;
+
+    goto yybackup;
+
+
+  /*-----------.
+  | yybackup.  |
+  `-----------*/
+  yybackup:
+    // Try to take a decision without lookahead.
+    yyn = yypact_[+yystack_[0].state];
+    if (yy_pact_value_is_default_ (yyn))
+      goto yydefault;
+
+    // Read a lookahead token.
+    if (yyla.empty ())
+      {
+        YYCDEBUG << "Reading a token\n";
+#if YY_EXCEPTIONS
+        try
+#endif // YY_EXCEPTIONS
+          {
+            symbol_type yylookahead (yylex (driver));
+            yyla.move (yylookahead);
+          }
+#if YY_EXCEPTIONS
+        catch (const syntax_error& yyexc)
+          {
+            YYCDEBUG << "Caught exception: " << yyexc.what() << '\n';
+            error (yyexc);
+            goto yyerrlab1;
+          }
+#endif // YY_EXCEPTIONS
+      }
+    YY_SYMBOL_PRINT ("Next token is", yyla);
+
+    if (yyla.kind () == symbol_kind::S_YYerror)
+    {
+      // The scanner already issued an error message, process directly
+      // to error recovery.  But do not keep the error token as
+      // lookahead, it is too special and may lead us to an endless
+      // loop in error recovery. */
+      yyla.kind_ = symbol_kind::S_YYUNDEF;
+      goto yyerrlab1;
+    }
+
+    /* If the proper action on seeing token YYLA.TYPE is to reduce or
+       to detect an error, take that action.  */
+    yyn += yyla.kind ();
+    if (yyn < 0 || yylast_ < yyn || yycheck_[yyn] != yyla.kind ())
+      {
+        goto yydefault;
+      }
+
+    // Reduce or error.
+    yyn = yytable_[yyn];
+    if (yyn <= 0)
+      {
+        if (yy_table_value_is_error_ (yyn))
+          goto yyerrlab;
+        yyn = -yyn;
+        goto yyreduce;
+      }
+
+    // Count tokens shifted since error; after three, turn off error status.
+    if (yyerrstatus_)
+      --yyerrstatus_;
+
+    // Shift the lookahead token.
+    yypush_ ("Shifting", state_type (yyn), YY_MOVE (yyla));
+    goto yynewstate;
+
+
+  /*-----------------------------------------------------------.
+  | yydefault -- do the default action for the current state.  |
+  `-----------------------------------------------------------*/
+  yydefault:
+    yyn = yydefact_[+yystack_[0].state];
+    if (yyn == 0)
+      goto yyerrlab;
+    goto yyreduce;
+
+
+  /*-----------------------------.
+  | yyreduce -- do a reduction.  |
+  `-----------------------------*/
+  yyreduce:
+    yylen = yyr2_[yyn];
+    {
+      stack_symbol_type yylhs;
+      yylhs.state = yy_lr_goto_state_ (yystack_[yylen].state, yyr1_[yyn]);
+      /* Variants are always initialized to an empty instance of the
+         correct type. The default '$$ = $1' action is NOT applied
+         when using variants.  */
+      switch (yyr1_[yyn])
+    {
+      case symbol_kind::S_statements: // statements
+      case symbol_kind::S_block: // block
+      case symbol_kind::S_statement: // statement
+      case symbol_kind::S_initialization: // initialization
+      case symbol_kind::S_inc_dec: // inc_dec
+      case symbol_kind::S_any_expr: // any_expr
+      case symbol_kind::S_assign: // assign
+      case symbol_kind::S_ternary: // ternary
+      case symbol_kind::S_equality: // equality
+      case symbol_kind::S_comparison: // comparison
+      case symbol_kind::S_expr: // expr
+      case symbol_kind::S_term: // term
+      case symbol_kind::S_prim: // prim
+      case symbol_kind::S_modifiable: // modifiable
+      case symbol_kind::S_def_modifiable: // def_modifiable
+        yylhs.value.emplace< IASTNode* > ();
+        break;
+
+      case symbol_kind::S_NUMBER: // "number"
+        yylhs.value.emplace< double > ();
+        break;
+
+      case symbol_kind::S_func_def_args: // func_def_args
+      case symbol_kind::S_func_call_args: // func_call_args
+        yylhs.value.emplace< std::list<IASTNode*>* > ();
+        break;
+
+      case symbol_kind::S_init_list: // init_list
+        yylhs.value.emplace< std::vector<double>* > ();
+        break;
+
+      case symbol_kind::S_NAME: // "name"
+        yylhs.value.emplace< unsigned int > ();
+        break;
+
+      default:
+        break;
+    }
+
+
+      // Default location.
+      {
+        stack_type::slice range (yystack_, yylen);
+        YYLLOC_DEFAULT (yylhs.location, range, yylen);
+        yyerror_range[1].location = yylhs.location;
+      }
+
+      // Perform the reduction.
+      YY_REDUCE_PRINT (yyn);
+#if YY_EXCEPTIONS
+      try
+#endif // YY_EXCEPTIONS
+        {
+          switch (yyn)
+            {
+  case 4: // $@1: %empty
+#line 86 "CalcParser.yy"
+                  { 
+		driver.scopes.open();
+		driver.array_lengths.clear();
+	}
+#line 847 "CalcParser.tab.cc"
+    break;
+
+  case 5: // function: "function" "name" $@1 "(" func_def_args ")" "{" statements "}"
+#line 89 "CalcParser.yy"
+                                                                         {
+		ParserFunc* pf = new ParserFunc;
+		pf->name = driver.names.name(yystack_[7].value.as < unsigned int > ());
+		while (!yystack_[4].value.as < std::list<IASTNode*>* > ()->empty()) {
+			pf->arg.push_back(yystack_[4].value.as < std::list<IASTNode*>* > ()->front());
+			yystack_[4].value.as < std::list<IASTNode*>* > ()->pop_front();
+		}
+		delete yystack_[4].value.as < std::list<IASTNode*>* > ();
+		pf->body = yystack_[1].value.as < IASTNode* > ();
+		pf->array_lengths = driver.array_lengths;
+		if (0 == driver.functable.put(pf)) {
+			driver.error("Function appears second time");
+		}
+		
+		// check is result exist
+		if (!driver.scopes.local(driver.names.intern("result")))
+			driver.error("Function '" + driver.names.name(yystack_[7].value.as < unsigned int > ()) + "' is not returning result");
+		
+		driver.scopes.close();
+	}
+#line 872 "CalcParser.tab.cc"
+    break;
+
+  case 6: // statements: statement
+#line 111 "CalcParser.yy"
+                  { yylhs.value.as < IASTNode* > () = yystack_[0].value.as < IASTNode* > (); }
+#line 878 "CalcParser.tab.cc"
+    break;
+
+  case 7: // statements: statements statement
+#line 112 "CalcParser.yy"
+                               { 
+		ASTNoRetBinaryOpNode* parent = new ASTNoRetBinaryOpNode(STATEMENTS);
+		parent->set(yystack_[1].value.as < IASTNode* > (), yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 889 "CalcParser.tab.cc"
+    break;
+
+  case 8: // block: "{" "}"
+#line 120 "CalcParser.yy"
+                                {
+		yylhs.value.as < IASTNode* > () = new ASTEmptyNode();
+	}
+#line 897 "CalcParser.tab.cc"
+    break;
+
+  case 9: // $@2: %empty
+#line 123 "CalcParser.yy"
+                      {
+		driver.scopes.open();
+	}
+#line 905 "CalcParser.tab.cc"
+    break;
+
+  case 10: // block: "{" $@2 statements "}"
+#line 126 "CalcParser.yy"
+                               {
+		driver.scopes.close();
+		yylhs.value.as < IASTNode* > () = yystack_[1].value.as < IASTNode* > ();
+	}
+#line 914 "CalcParser.tab.cc"
+    break;
+
+  case 11: // statement: block
+#line 132 "CalcParser.yy"
+              { yylhs.value.as < IASTNode* > () = yystack_[0].value.as < IASTNode* > (); }
+#line 920 "CalcParser.tab.cc"
+    break;
+
+  case 12: // statement: "while" "(" any_expr ")" statement
+#line 133 "CalcParser.yy"
+                                                 { 
+		ASTNoRetBinaryOpNode* parent = new ASTNoRetBinaryOpNode(WHILE_CYCLE);
+		parent->set(yystack_[2].value.as < IASTNode* > (), yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 931 "CalcParser.tab.cc"
+    break;
+
+  case 13: // statement: "if" "(" any_expr ")" block "else" block
+#line 139 "CalcParser.yy"
+                                                     { 
+		ASTNoRetTernaryOpNode* parent = new ASTNoRetTernaryOpNode(IF); 
+		parent->set(yystack_[4].value.as < IASTNode* > (), yystack_[2].value.as < IASTNode* > (), yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 942 "CalcParser.tab.cc"
+    break;
+
+  case 14: // statement: "if" "(" any_expr ")" block
+#line 145 "CalcParser.yy"
+                                          {
+		ASTNoRetTernaryOpNode* parent = new ASTNoRetTernaryOpNode(IF);
+		parent->set(yystack_[2].value.as < IASTNode* > (), yystack_[0].value.as < IASTNode* > (), new ASTEmptyNode);
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 953 "CalcParser.tab.cc"
+    break;
+
+  case 15: // statement: initialization ";"
+#line 151 "CalcParser.yy"
+                                   { yylhs.value.as < IASTNode* > () = yystack_[1].value.as < IASTNode* > (); }
+#line 959 "CalcParser.tab.cc"
+    break;
+
+  case 16: // statement: inc_dec ";"
+#line 152 "CalcParser.yy"
+                            { yylhs.value.as < IASTNode* > () = yystack_[1].value.as < IASTNode* > (); }
+#line 965 "CalcParser.tab.cc"
+    break;
+
+  case 17: // initialization: "name"
+#line 155 "CalcParser.yy"
+             {
+		const ScopeTable::Symbol* symbol = driver.scopes.find(yystack_[0].value.as < unsigned int > ());
+		if (symbol != NULL) {
+			if (symbol->size != 0) 
+				driver.error("Variable name '" + driver.names.name(yystack_[0].value.as < unsigned int > ()) + "' the same as array name");
+			yylhs.value.as < IASTNode* > () = new ASTLeafVar(symbol->id);
+		} else {
+			ASTAssignNode* parent = new ASTAssignNode();
+			parent->set(new ASTLeafVar(driver.declare(yystack_[0].value.as < unsigned int > (), 0, false).id), new ASTLeafNum(0.0));
+			parent->set_location(yylhs.location);
+			yylhs.value.as < IASTNode* > () = parent;
+		}
+	}
+#line 983 "CalcParser.tab.cc"
+    break;
+
+  case 18: // initialization: "name" "=" any_expr
+#line 168 "CalcParser.yy"
+                               {
+		const ScopeTable::Symbol* symbol = driver.scopes.find(yystack_[2].value.as < unsigned int > ());
+		if (symbol != NULL) {
+			if (symbol->size != 0) 
+				driver.error("Variable name '" + driver.names.name(yystack_[2].value.as < unsigned int > ()) + "' the same as array name");
+		} else {
+			symbol = &driver.declare(yystack_[2].value.as < unsigned int > (), 0, false);
+		}
+		ASTAssignNode* parent = new ASTAssignNode();
+		parent->set(new ASTLeafVar(symbol->id), yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1001 "CalcParser.tab.cc"
+    break;
+
+  case 19: // initialization: "name" "[" any_expr "]" "=" "[" init_list "]"
+#line 181 "CalcParser.yy"
+                                                                                             {
+		const ScopeTable::Symbol* symbol = driver.scopes.find(yystack_[7].value.as < unsigned int > ());
+		if (symbol != NULL) {
+			if (symbol->size == 0) 
+				driver.error("Variable name '" + driver.names.name(yystack_[7].value.as < unsigned int > ()) + "' the same as array name");
+			if (driver.scopes.local(yystack_[7].value.as < unsigned int > ())) driver.error("Array double initialization");
+		}
+		if (yystack_[5].value.as < IASTNode* > ()->get_op() != NUMBER) driver.error("Array initialization with unknown size");
+		double number = dynamic_cast<ASTLeafNum*>(yystack_[5].value.as < IASTNode* > ())->get();
+		delete yystack_[5].value.as < IASTNode* > ();
+		if (number < 1.0) driver.error("Array size less than 1");
+		if (number > 1e9) driver.error("Array size too big");
+		unsigned int array_size = static_cast<unsigned int>(number);
+		const ScopeTable::Symbol& array = driver.declare(yystack_[7].value.as < unsigned int > (), array_size, true);
+		if (yystack_[1].value.as < std::vector<double>* > ()->size() > array_size) driver.error("Init list too long");
+		
+		ASTArrayInitNode* init = new ASTArrayInitNode(new ASTLeafVar(array.id, array.slot));
+		init->values().swap(*yystack_[1].value.as < std::vector<double>* > ());
+		delete yystack_[1].value.as < std::vector<double>* > ();
+		init->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = init;
+	}
+#line 1028 "CalcParser.tab.cc"
+    break;
+
+  case 20: // initialization: "name" "[" any_expr "]" "=" any_expr
+#line 203 "CalcParser.yy"
+                                                                  {
+		const ScopeTable::Symbol* symbol = driver.scopes.find(yystack_[5].value.as < unsigned int > ());
+		if (symbol == NULL) driver.error("Array '" + driver.names.name(yystack_[5].value.as < unsigned int > ()) + "' not initialized");
+		if (symbol->size == 0) 
+			driver.error("Variable name '" + driver.names.name(yystack_[5].value.as < unsigned int > ()) + "' the same as array name");
+		ASTIndexNode* index = new ASTIndexNode();
+		index->set(new ASTLeafVar(symbol->id, symbol->slot), yystack_[3].value.as < IASTNode* > ());
+		index->set_slot(symbol->slot);
+		ASTAssignNode* parent = new ASTAssignNode();
+		parent->set(index, yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1046 "CalcParser.tab.cc"
+    break;
+
+  case 21: // initialization: "name" "[" any_expr "]"
+#line 216 "CalcParser.yy"
+                                                  {
+		const ScopeTable::Symbol* symbol = driver.scopes.find(yystack_[3].value.as < unsigned int > ());
+		if (symbol != NULL) {
+			if (symbol->size == 0) 
+				driver.error("Variable name '" + driver.names.name(yystack_[3].value.as < unsigned int > ()) + "' the same as array name");
+			if (driver.scopes.local(yystack_[3].value.as < unsigned int > ())) driver.error("Array double initialization");
+		}
+		if (yystack_[1].value.as < IASTNode* > ()->get_op() != NUMBER) driver.error("Array initialization with unknown size");
+		double number = dynamic_cast<ASTLeafNum*>(yystack_[1].value.as < IASTNode* > ())->get();
+		delete yystack_[1].value.as < IASTNode* > ();
+		if (number < 1.0) driver.error("Array size less than 1");
+		if (number > 1e9) driver.error("Array size too big");
+		driver.declare(yystack_[3].value.as < unsigned int > (), static_cast<unsigned int>(number), true);
+		
+		yylhs.value.as < IASTNode* > () = new ASTEmptyNode();
+	}
+#line 1067 "CalcParser.tab.cc"
+    break;
+
+  case 22: // inc_dec: modifiable "++"
+#line 234 "CalcParser.yy"
+                       { 
+		ASTIncrOpNode* parent = new ASTIncrOpNode(POST_INC);
+		parent->set(yystack_[1].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1078 "CalcParser.tab.cc"
+    break;
+
+  case 23: // inc_dec: modifiable "--"
+#line 240 "CalcParser.yy"
+                         {
+		ASTIncrOpNode* parent = new ASTIncrOpNode(POST_DEC);
+		parent->set(yystack_[1].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1089 "CalcParser.tab.cc"
+    break;
+
+  case 24: // inc_dec: "++" modifiable
+#line 246 "CalcParser.yy"
+                         {
+		ASTIncrOpNode* parent = new ASTIncrOpNode(PRE_INC);
+		parent->set(yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1100 "CalcParser.tab.cc"
+    break;
+
+  case 25: // inc_dec: "--" modifiable
+#line 252 "CalcParser.yy"
+                         {
+		ASTIncrOpNode* parent = new ASTIncrOpNode(PRE_DEC);
+		parent->set(yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1111 "CalcParser.tab.cc"
+    break;
+
+  case 26: // any_expr: assign
+#line 260 "CalcParser.yy"
+               { yylhs.value.as < IASTNode* > () = yystack_[0].value.as < IASTNode* > (); }
+#line 1117 "CalcParser.tab.cc"
+    break;
+
+  case 27: // any_expr: ternary
+#line 261 "CalcParser.yy"
+                  { yylhs.value.as < IASTNode* > () = yystack_[0].value.as < IASTNode* > (); }
+#line 1123 "CalcParser.tab.cc"
+    break;
+
+  case 28: // assign: modifiable "=" any_expr
+#line 264 "CalcParser.yy"
+                                   {
+		ASTAssignNode* parent = new ASTAssignNode();
+		parent->set(yystack_[2].value.as < IASTNode* > (), yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1134 "CalcParser.tab.cc"
+    break;
+
+  case 29: // ternary: equality
+#line 272 "CalcParser.yy"
+                 { yylhs.value.as < IASTNode* > () = yystack_[0].value.as < IASTNode* > (); }
+#line 1140 "CalcParser.tab.cc"
+    break;
+
+  case 30: // ternary: equality "?" any_expr ":" ternary
+#line 273 "CalcParser.yy"
+                                                   { 
+		ASTTernaryOpNode* parent = new ASTTernaryOpNode(TERNARY);
+		parent->set(yystack_[4].value.as < IASTNode* > (), yystack_[2].value.as < IASTNode* > (), yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1151 "CalcParser.tab.cc"
+    break;
+
+  case 31: // equality: comparison
+#line 281 "CalcParser.yy"
+                   { yylhs.value.as < IASTNode* > () = yystack_[0].value.as < IASTNode* > (); }
+#line 1157 "CalcParser.tab.cc"
+    break;
+
+  case 32: // equality: equality "==" comparison
+#line 282 "CalcParser.yy"
+                                    { 
+		ASTBinaryOpNode* parent = new ASTBinaryOpNode(EQUALITY);
+		parent->set(yystack_[2].value.as < IASTNode* > (), yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1168 "CalcParser.tab.cc"
+    break;
+
+  case 33: // equality: equality "!=" comparison
+#line 288 "CalcParser.yy"
+                                       { 
+		ASTBinaryOpNode* parent = new ASTBinaryOpNode(NEQUALITY);
+		parent->set(yystack_[2].value.as < IASTNode* > (), yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1179 "CalcParser.tab.cc"
+    break;
+
+  case 34: // comparison: expr
+#line 296 "CalcParser.yy"
+             { yylhs.value.as < IASTNode* > () = yystack_[0].value.as < IASTNode* > (); }
+#line 1185 "CalcParser.tab.cc"
+    break;
+
+  case 35: // comparison: comparison "<" expr
+#line 297 "CalcParser.yy"
+                               { 
+		ASTBinaryOpNode* parent = new ASTBinaryOpNode(LESS);
+		parent->set(yystack_[2].value.as < IASTNode* > (), yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1196 "CalcParser.tab.cc"
+    break;
+
+  case 36: // comparison: comparison "<=" expr
+#line 303 "CalcParser.yy"
+                                    { 
+		ASTBinaryOpNode* parent = new ASTBinaryOpNode(LESS_EQUAL);
+		parent->set(yystack_[2].value.as < IASTNode* > (), yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1207 "CalcParser.tab.cc"
+    break;
+
+  case 37: // comparison: comparison ">" expr
+#line 309 "CalcParser.yy"
+                                  { 
+		ASTBinaryOpNode* parent = new ASTBinaryOpNode(GREATER);
+		parent->set(yystack_[2].value.as < IASTNode* > (), yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1218 "CalcParser.tab.cc"
+    break;
+
+  case 38: // comparison: comparison ">=" expr
+#line 315 "CalcParser.yy"
+                                       { 
+		ASTBinaryOpNode* parent = new ASTBinaryOpNode(GREATER_EQUAL);
+		parent->set(yystack_[2].value.as < IASTNode* > (), yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1229 "CalcParser.tab.cc"
+    break;
+
+  case 39: // expr: term
+#line 323 "CalcParser.yy"
+             { yylhs.value.as < IASTNode* > () = yystack_[0].value.as < IASTNode* > (); }
+#line 1235 "CalcParser.tab.cc"
+    break;
+
+  case 40: // expr: expr "+" term
+#line 324 "CalcParser.yy"
+                        { 
+		ASTBinaryOpNode* parent = new ASTBinaryOpNode(ADD);
+		parent->set(yystack_[2].value.as < IASTNode* > (), yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1246 "CalcParser.tab.cc"
+    break;
+
+  case 41: // expr: expr "-" term
+#line 330 "CalcParser.yy"
+                        { 
+		ASTBinaryOpNode* parent = new ASTBinaryOpNode(SUB);
+		parent->set(yystack_[2].value.as < IASTNode* > (), yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1257 "CalcParser.tab.cc"
+    break;
+
+  case 42: // term: prim
+#line 338 "CalcParser.yy"
+             { yylhs.value.as < IASTNode* > () = yystack_[0].value.as < IASTNode* > (); }
+#line 1263 "CalcParser.tab.cc"
+    break;
+
+  case 43: // term: term "*" prim
+#line 339 "CalcParser.yy"
+                        { 
+		ASTBinaryOpNode* parent = new ASTBinaryOpNode(MUL);
+		parent->set(yystack_[2].value.as < IASTNode* > (), yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1274 "CalcParser.tab.cc"
+    break;
+
+  case 44: // term: term "/" prim
+#line 345 "CalcParser.yy"
+                        { 
+		ASTBinaryOpNode* parent = new ASTBinaryOpNode(DIV);
+		parent->set(yystack_[2].value.as < IASTNode* > (), yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1285 "CalcParser.tab.cc"
+    break;
+
+  case 45: // prim: "(" any_expr ")"
+#line 353 "CalcParser.yy"
+                               { yylhs.value.as < IASTNode* > () = yystack_[1].value.as < IASTNode* > (); }
+#line 1291 "CalcParser.tab.cc"
+    break;
+
+  case 46: // prim: "-" prim
+#line 354 "CalcParser.yy"
+                   { 
+		ASTUnaryOpNode* parent = new ASTUnaryOpNode(UNARY_MINUS);
+		parent->set(yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1302 "CalcParser.tab.cc"
+    break;
+
+  case 47: // prim: "!" prim
+#line 360 "CalcParser.yy"
+                   { 
+		ASTUnaryOpNode* parent = new ASTUnaryOpNode(NOT);
+		parent->set(yystack_[0].value.as < IASTNode* > ());
+		parent->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = parent;
+	}
+#line 1313 "CalcParser.tab.cc"
+    break;
+
+  case 48: // prim: "number"
+#line 366 "CalcParser.yy"
+                 {
+		yylhs.value.as < IASTNode* > () = new ASTLeafNum(yystack_[0].value.as < double > ());
+		yylhs.value.as < IASTNode* > ()->set_location(yylhs.location);
+	}
+#line 1322 "CalcParser.tab.cc"
+    break;
+
+  case 49: // prim: "name" "(" func_call_args ")"
+#line 370 "CalcParser.yy"
+                                            {
+		ASTFuncCallNode* func = new ASTFuncCallNode(driver.names.name(yystack_[3].value.as < unsigned int > ()));
+		while (!yystack_[1].value.as < std::list<IASTNode*>* > ()->empty()) {
+			func->set_args(yystack_[1].value.as < std::list<IASTNode*>* > ()->front());
+			yystack_[1].value.as < std::list<IASTNode*>* > ()->pop_front();
+		}
+		delete yystack_[1].value.as < std::list<IASTNode*>* > ();
+		func->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = func;
+	}
+#line 1337 "CalcParser.tab.cc"
+    break;
+
+  case 50: // prim: modifiable
+#line 380 "CalcParser.yy"
+                     { yylhs.value.as < IASTNode* > () = yystack_[0].value.as < IASTNode* > (); }
+#line 1343 "CalcParser.tab.cc"
+    break;
+
+  case 51: // prim: inc_dec
+#line 381 "CalcParser.yy"
+                  { yylhs.value.as < IASTNode* > () = yystack_[0].value.as < IASTNode* > (); }
+#line 1349 "CalcParser.tab.cc"
+    break;
+
+  case 52: // modifiable: "name"
+#line 384 "CalcParser.yy"
+             {
+		const ScopeTable::Symbol* symbol = driver.scopes.find(yystack_[0].value.as < unsigned int > ());
+		if (symbol == NULL) driver.error("Variable '" + driver.names.name(yystack_[0].value.as < unsigned int > ()) + "' not found");
+		// array name is allowed as function argument
+		yylhs.value.as < IASTNode* > () = new ASTLeafVar(symbol->id, symbol->slot);
+		yylhs.value.as < IASTNode* > ()->set_location(yylhs.location);
+	}
+#line 1361 "CalcParser.tab.cc"
+    break;
+
+  case 53: // modifiable: "name" "[" any_expr "]"
+#line 391 "CalcParser.yy"
+                                                  {
+		const ScopeTable::Symbol* symbol = driver.scopes.find(yystack_[3].value.as < unsigned int > ());
+		if (symbol == NULL) driver.error("Array '" + driver.names.name(yystack_[3].value.as < unsigned int > ()) + "' not found");
+		if (symbol->size == 0)
+			driver.error("Variable name '" + driver.names.name(yystack_[3].value.as < unsigned int > ()) + "' the same as array name");
+		ASTIndexNode* index = new ASTIndexNode();
+		index->set(new ASTLeafVar(symbol->id, symbol->slot), yystack_[1].value.as < IASTNode* > ());
+		index->set_slot(symbol->slot);
+		index->set_location(yylhs.location);
+		yylhs.value.as < IASTNode* > () = index;
+	}
+#line 1377 "CalcParser.tab.cc"
+    break;
+
+  case 54: // init_list: %empty
+#line 404 "CalcParser.yy"
+                    { yylhs.value.as < std::vector<double>* > () = new std::vector<double>; }
+#line 1383 "CalcParser.tab.cc"
+    break;
+
+  case 55: // init_list: "number"
+#line 405 "CalcParser.yy"
+                 { 
+		yylhs.value.as < std::vector<double>* > () = new std::vector<double>; 
+		yylhs.value.as < std::vector<double>* > ()->push_back(yystack_[0].value.as < double > ());
+	}
+#line 1392 "CalcParser.tab.cc"
+    break;
+
+  case 56: // init_list: init_list "," "number"
+#line 409 "CalcParser.yy"
+                                 { 
+		yystack_[2].value.as < std::vector<double>* > ()->push_back(yystack_[0].value.as < double > ());
+		yylhs.value.as < std::vector<double>* > () = yystack_[2].value.as < std::vector<double>* > ();
+	}
+#line 1401 "CalcParser.tab.cc"
+    break;
+
+  case 57: // func_def_args: %empty
+#line 415 "CalcParser.yy"
+                    { yylhs.value.as < std::list<IASTNode*>* > () = new std::list<IASTNode*>; }
+#line 1407 "CalcParser.tab.cc"
+    break;
+
+  case 58: // func_def_args: def_modifiable
+#line 416 "CalcParser.yy"
+                         {
+		yylhs.value.as < std::list<IASTNode*>* > () = new std::list<IASTNode*>; 
+		yylhs.value.as < std::list<IASTNode*>* > ()->push_back(yystack_[0].value.as < IASTNode* > ());
+	}
+#line 1416 "CalcParser.tab.cc"
+    break;
+
+  case 59: // func_def_args: func_def_args "," def_modifiable
+#line 420 "CalcParser.yy"
+                                             { 
+		yystack_[2].value.as < std::list<IASTNode*>* > ()->push_back(yystack_[0].value.as < IASTNode* > ());
+		yylhs.value.as < std::list<IASTNode*>* > () = yystack_[2].value.as < std::list<IASTNode*>* > ();
+	}
+#line 1425 "CalcParser.tab.cc"
+    break;
+
+  case 60: // def_modifiable: "name"
+#line 426 "CalcParser.yy"
+             {
+		yylhs.value.as < IASTNode* > () = new ASTLeafVar(driver.declare(yystack_[0].value.as < unsigned int > (), 0, false).id);
+	}
+#line 1433 "CalcParser.tab.cc"
+    break;
+
+  case 61: // def_modifiable: "name" "[" "number" "]"
+#line 429 "CalcParser.yy"
+                                                {
+		if (yystack_[1].value.as < double > () < 0.0) driver.error("Array size less than zero");
+		if (yystack_[1].value.as < double > () > 1e9) driver.error("Array size too big");
+		const ScopeTable::Symbol& array = driver.declare(yystack_[3].value.as < unsigned int > (), static_cast<unsigned int>(yystack_[1].value.as < double > ()), true);
+		ASTIndexNode* index = new ASTIndexNode();
+		index->set(new ASTLeafVar(array.id, array.slot), new ASTLeafNum(yystack_[1].value.as < double > ()));
+		index->set_slot(array.slot);
+		yylhs.value.as < IASTNode* > () = index;
+	}
+#line 1447 "CalcParser.tab.cc"
+    break;
+
+  case 62: // func_call_args: %empty
+#line 440 "CalcParser.yy"
+                    { yylhs.value.as < std::list<IASTNode*>* > () = new std::list<IASTNode*>; }
+#line 1453 "CalcParser.tab.cc"
+    break;
+
+  case 63: // func_call_args: any_expr
+#line 441 "CalcParser.yy"
+                   { 
+		yylhs.value.as < std::list<IASTNode*>* > () = new std::list<IASTNode*>;
+		yylhs.value.as < std::list<IASTNode*>* > ()->push_back(yystack_[0].value.as < IASTNode* > ());
+	}
+#line 1462 "CalcParser.tab.cc"
+    break;
+
+  case 64: // func_call_args: func_call_args "," any_expr
+#line 445 "CalcParser.yy"
+                                        { 
+		yystack_[2].value.as < std::list<IASTNode*>* > ()->push_back(yystack_[0].value.as < IASTNode* > ());
+		yylhs.value.as < std::list<IASTNode*>* > () = yystack_[2].value.as < std::list<IASTNode*>* > ();
+	}
+#line 1471 "CalcParser.tab.cc"
+    break;
+
+
+#line 1475 "CalcParser.tab.cc"
+
+            default:
+              break;
+            }
+        }
+#if YY_EXCEPTIONS
+      catch (const syntax_error& yyexc)
+        {
+          YYCDEBUG << "Caught exception: " << yyexc.what() << '\n';
+          error (yyexc);
+          YYERROR;
+        }
+#endif // YY_EXCEPTIONS
+      YY_SYMBOL_PRINT ("-> $$ =", yylhs);
+      yypop_ (yylen);
+      yylen = 0;
+
+      // Shift the result of the reduction.
+      yypush_ (YY_NULLPTR, YY_MOVE (yylhs));
+    }
+    goto yynewstate;
+
+
+  /*--------------------------------------.
+  | yyerrlab -- here on detecting error.  |
+  `--------------------------------------*/
+  yyerrlab:
+    // If not already recovering from an error, report this error.
+    if (!yyerrstatus_)
+      {
+        ++yynerrs_;
+        context yyctx (*this, yyla);
+        std::string msg = yysyntax_error_ (yyctx);
+        error (yyla.location, YY_MOVE (msg));
+      }
+
+
+    yyerror_range[1].location = yyla.location;
+    if (yyerrstatus_ == 3)
+      {
+        /* If just tried and failed to reuse lookahead token after an
+           error, discard it.  */
+
+        // Return failure if at end of input.
+        if (yyla.kind () == symbol_kind::S_YYEOF)
+          YYABORT;
+        else if (!yyla.empty ())
+          {
+            yy_destroy_ ("Error: discarding", yyla);
+            yyla.clear ();
+          }
+      }
+
+    // Else will try to reuse lookahead token after shifting the error token.
+    goto yyerrlab1;
+
+
+  /*---------------------------------------------------.
+  | yyerrorlab -- error raised explicitly by YYERROR.  |
+  `---------------------------------------------------*/
+  yyerrorlab:
+    /* Pacify compilers when the user code never invokes YYERROR and
+       the label yyerrorlab therefore never appears in user code.  */
+    if (false)
+      YYERROR;
+
+    /* Do not reclaim the symbols of the rule whose action triggered
+       this YYERROR.  */
+    yypop_ (yylen);
+    yylen = 0;
+    YY_STACK_PRINT ();
+    goto yyerrlab1;
+
+
+  /*-------------------------------------------------------------.
+  | yyerrlab1 -- common code for both syntax error and YYERROR.  |
+  `-------------------------------------------------------------*/
+  yyerrlab1:
+    yyerrstatus_ = 3;   // Each real token shifted decrements this.
+    // Pop stack until we find a state that shifts the error token.
+    for (;;)
+      {
+        yyn = yypact_[+yystack_[0].state];
+        if (!yy_pact_value_is_default_ (yyn))
+          {
+            yyn += symbol_kind::S_YYerror;
+            if (0 <= yyn && yyn <= yylast_
+                && yycheck_[yyn] == symbol_kind::S_YYerror)
+              {
+                yyn = yytable_[yyn];
+                if (0 < yyn)
+                  break;
+              }
+          }
+
+        // Pop the current state because it cannot handle the error token.
+        if (yystack_.size () == 1)
+          YYABORT;
+
+        yyerror_range[1].location = yystack_[0].location;
+        yy_destroy_ ("Error: popping", yystack_[0]);
+        yypop_ ();
+        YY_STACK_PRINT ();
+      }
+    {
+      stack_symbol_type error_token;
+
+      yyerror_range[2].location = yyla.location;
+      YYLLOC_DEFAULT (error_token.location, yyerror_range, 2);
+
+      // Shift the error token.
+      error_token.state = state_type (yyn);
+      yypush_ ("Shifting", YY_MOVE (error_token));
+    }
+    goto yynewstate;
+
+
+  /*-------------------------------------.
+  | yyacceptlab -- YYACCEPT comes here.  |
+  `-------------------------------------*/
+  yyacceptlab:
+    yyresult = 0;
+    goto yyreturn;
+
+
+  /*-----------------------------------.
+  | yyabortlab -- YYABORT comes here.  |
+  `-----------------------------------*/
+  yyabortlab:
+    yyresult = 1;
+    goto yyreturn;
+
+
+  /*-----------------------------------------------------.
+  | yyreturn -- parsing is finished, return the result.  |
+  `-----------------------------------------------------*/
+  yyreturn:
+    if (!yyla.empty ())
+      yy_destroy_ ("Cleanup: discarding lookahead", yyla);
+
+    /* Do not reclaim the symbols of the rule whose action triggered
+       this YYABORT or YYACCEPT.  */
+    yypop_ (yylen);
+    YY_STACK_PRINT ();
+    while (1 < yystack_.size ())
+      {
+        yy_destroy_ ("Cleanup: popping", yystack_[0]);
+        yypop_ ();
+      }
+
+    return yyresult;
+  }
+#if YY_EXCEPTIONS
+    catch (...)
+      {
+        YYCDEBUG << "Exception caught: cleaning lookahead and stack\n";
+        // Do not try to display the values of the reclaimed symbols,
+        // as their printers might throw an exception.
+        if (!yyla.empty ())
+          yy_destroy_ (YY_NULLPTR, yyla);
+
+        while (1 < yystack_.size ())
+          {
+            yy_destroy_ (YY_NULLPTR, yystack_[0]);
+            yypop_ ();
+          }
+        throw;
+      }
+#endif // YY_EXCEPTIONS
+  }
+
+  void
+  CalcParser::error (const syntax_error& yyexc)
+  {
+    error (yyexc.location, yyexc.what ());
+  }
+
+  /* Return YYSTR after stripping away unnecessary quotes and
+     backslashes, so that it's suitable for yyerror.  The heuristic is
+     that double-quoting is unnecessary unless the string contains an
+     apostrophe, a comma, or backslash (other than backslash-backslash).
+     YYSTR is taken from yytname.  */
+  std::string
+  CalcParser::yytnamerr_ (const char *yystr)
+  {
+    if (*yystr == '"')
+      {
+        std::string yyr;
+        char const *yyp = yystr;
+
+        for (;;)
+          switch (*++yyp)
+            {
+            case '\'':
+            case ',':
+              goto do_not_strip_quotes;
+
+            case '\\':
+              if (*++yyp != '\\')
+                goto do_not_strip_quotes;
+              else
+                goto append;
+
+            append:
+            default:
+              yyr += *yyp;
+              break;
+
+            case '"':
+              return yyr;
+            }
+      do_not_strip_quotes: ;
+      }
+
+    return yystr;
+  }
+
+  std::string
+  CalcParser::symbol_name (symbol_kind_type yysymbol)
+  {
+    return yytnamerr_ (yytname_[yysymbol]);
+  }
+
+
+
+  // CalcParser::context.
+  CalcParser::context::context (const CalcParser& yyparser, const symbol_type& yyla)
+    : yyparser_ (yyparser)
+    , yyla_ (yyla)
+  {}
+
+  int
+  CalcParser::context::expected_tokens (symbol_kind_type yyarg[], int yyargn) const
+  {
+    // Actual number of expected tokens
+    int yycount = 0;
+
+    const int yyn = yypact_[+yyparser_.yystack_[0].state];
+    if (!yy_pact_value_is_default_ (yyn))
+      {
+        /* Start YYX at -YYN if negative to avoid negative indexes in
+           YYCHECK.  In other words, skip the first -YYN actions for
+           this state because they are default actions.  */
+        const int yyxbegin = yyn < 0 ? -yyn : 0;
+        // Stay within bounds of both yycheck and yytname.
+        const int yychecklim = yylast_ - yyn + 1;
+        const int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+        for (int yyx = yyxbegin; yyx < yyxend; ++yyx)
+          if (yycheck_[yyx + yyn] == yyx && yyx != symbol_kind::S_YYerror
+              && !yy_table_value_is_error_ (yytable_[yyx + yyn]))
+            {
+              if (!yyarg)
+                ++yycount;
+              else if (yycount == yyargn)
+                return 0;
+              else
+                yyarg[yycount++] = YY_CAST (symbol_kind_type, yyx);
+            }
+      }
+
+    if (yyarg && yycount == 0 && 0 < yyargn)
+      yyarg[0] = symbol_kind::S_YYEMPTY;
+    return yycount;
+  }
+
+
+
+
+
+
+  int
+  CalcParser::yy_syntax_error_arguments_ (const context& yyctx,
+                                                 symbol_kind_type yyarg[], int yyargn) const
+  {
+    /* There are many possibilities here to consider:
+       - If this state is a consistent state with a default action, then
+         the only way this function was invoked is if the default action
+         is an error action.  In that case, don't check for expected
+         tokens because there are none.
+       - The only way there can be no lookahead present (in yyla) is
+         if this state is a consistent state with a default action.
+         Thus, detecting the absence of a lookahead is sufficient to
+         determine that there is no unexpected or expected token to
+         report.  In that case, just report a simple "syntax error".
+       - Don't assume there isn't a lookahead just because this state is
+         a consistent state with a default action.  There might have
+         been a previous inconsistent state, consistent state with a
+         non-default action, or user semantic action that manipulated
+         yyla.  (However, yyla is currently not documented for users.)
+       - Of course, the expected token list depends on states to have
+         correct lookahead information, and it depends on the parser not
+         to perform extra reductions after fetching a lookahead from the
+         scanner and before detecting a syntax error.  Thus, state merging
+         (from LALR or IELR) and default reductions corrupt the expected
+         token list.  However, the list is correct for canonical LR with
+         one exception: it will still contain any token that will not be
+         accepted due to an error action in a later state.
+    */
+
+    if (!yyctx.lookahead ().empty ())
+      {
+        if (yyarg)
+          yyarg[0] = yyctx.token ();
+        int yyn = yyctx.expected_tokens (yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+        return yyn + 1;
+      }
+    return 0;
+  }
+
+  // Generate an error message.
+  std::string
+  CalcParser::yysyntax_error_ (const context& yyctx) const
+  {
+    // Its maximum.
+    enum { YYARGS_MAX = 5 };
+    // Arguments of yyformat.
+    symbol_kind_type yyarg[YYARGS_MAX];
+    int yycount = yy_syntax_error_arguments_ (yyctx, yyarg, YYARGS_MAX);
+
+    char const* yyformat = YY_NULLPTR;
+    switch (yycount)
+      {
+#define YYCASE_(N, S)                         \
+        case N:                               \
+          yyformat = S;                       \
+        break
+      default: // Avoid compiler warnings.
+        YYCASE_ (0, YY_("syntax error"));
+        YYCASE_ (1, YY_("syntax error, unexpected %s"));
+        YYCASE_ (2, YY_("syntax error, unexpected %s, expecting %s"));
+        YYCASE_ (3, YY_("syntax error, unexpected %s, expecting %s or %s"));
+        YYCASE_ (4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
+        YYCASE_ (5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
+#undef YYCASE_
+      }
+
+    std::string yyres;
+    // Argument number.
+    std::ptrdiff_t yyi = 0;
+    for (char const* yyp = yyformat; *yyp; ++yyp)
+      if (yyp[0] == '%' && yyp[1] == 's' && yyi < yycount)
+        {
+          yyres += symbol_name (yyarg[yyi++]);
+          ++yyp;
+        }
+      else
+        yyres += *yyp;
+    return yyres;
+  }
+
+
+  const signed char CalcParser::yypact_ninf_ = -69;
+
+  const signed char CalcParser::yytable_ninf_ = -22;
+
+  const short
+  CalcParser::yypact_[] =
+  {
+     -20,    -7,     8,   -69,   -69,   -69,   -69,    22,    17,    28,
+      63,   -69,    23,    80,    17,    93,    75,   -69,   -69,    66,
+      78,    78,   105,   114,    26,    35,   -69,   -69,   113,   115,
+      92,   -69,    75,   118,   -69,   -69,    55,    55,    55,    55,
+     -69,   -69,   -69,   -69,   -69,   -69,    68,    55,    55,    55,
+      55,    84,   -69,   -69,   123,   -69,   -69,    64,    88,   116,
+     117,   -69,    48,   124,   121,   -69,   -69,   122,   -69,    92,
+     127,   -69,    55,    75,    55,    55,    55,    55,    55,    55,
+      55,    55,    55,    55,    55,    55,   128,    -3,   -69,   -69,
+     -69,    67,   -69,   125,    88,    88,   116,   116,   116,   116,
+     117,   117,   -69,   -69,   -69,   106,    21,   -69,    55,    55,
+     128,   108,   -69,   -69,   -69,   -69,   -69,    86,   -69,   109,
+     -69
+  };
+
+  const signed char
+  CalcParser::yydefact_[] =
+  {
+       0,     0,     0,     2,     4,     1,     3,     0,    57,    60,
+       0,    58,     0,     0,     0,     0,     0,    59,    61,     9,
+       0,     0,     0,     0,    52,     0,    11,     6,     0,     0,
+       0,     8,     0,    52,    24,    25,     0,     0,     0,     0,
+       5,     7,    15,    16,    22,    23,     0,     0,     0,     0,
+       0,    52,    48,    51,     0,    26,    27,    29,    31,    34,
+      39,    42,    50,     0,     0,    18,    10,     0,    46,    50,
+       0,    47,    62,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,    53,    53,    45,
+      63,     0,    12,     0,    32,    33,    37,    35,    38,    36,
+      40,    41,    43,    44,    28,    14,     0,    49,     0,     0,
+       0,    54,    20,    64,    30,    13,    55,     0,    19,     0,
+      56
+  };
+
+  const short
+  CalcParser::yypgoto_[] =
+  {
+     -69,   -69,   136,   -69,   110,   -68,   -69,   -19,   -69,    -6,
+     -36,   -69,    34,   -69,    49,    36,    45,   -33,   -16,   -69,
+     -69,   130,   -69
+  };
+
+  const signed char
+  CalcParser::yydefgoto_[] =
+  {
+       0,     2,     3,     7,    25,    26,    32,    27,    28,    53,
+      54,    55,    56,    57,    58,    59,    60,    61,    69,   117,
+      10,    11,    91
+  };
+
+  const signed char
+  CalcParser::yytable_[] =
+  {
+      30,    63,    64,    65,    34,    35,    41,     1,     5,    30,
+      29,    67,   -21,    70,   106,    68,    30,    71,   105,    29,
+      62,    62,    62,    62,     4,    48,    29,    41,    49,     8,
+      30,    62,   111,    62,    50,     1,    90,    38,    93,    12,
+      29,   -17,   115,    39,    19,    40,    20,    21,     9,   104,
+     102,   103,    51,    52,    92,    15,    62,    30,    62,    48,
+      20,    21,    49,    22,    23,    85,    24,    29,    50,    62,
+     112,    13,   113,    44,    45,   107,    31,    19,    66,    14,
+      20,    21,    74,   108,    19,    75,    51,    52,    76,    16,
+      62,    72,    62,    20,    21,    47,    22,    23,   118,    24,
+      20,    21,   119,    22,    23,    18,    24,    77,    78,    33,
+      79,    80,    36,    96,    97,    98,    99,    44,    45,    81,
+      82,    37,    83,    84,    94,    95,   100,   101,    42,    47,
+      43,    73,    86,    87,    88,    89,   110,    19,     6,   109,
+     116,   120,    46,   114,    17
+  };
+
+  const signed char
+  CalcParser::yycheck_[] =
+  {
+      16,    37,    38,    39,    20,    21,    25,    27,     0,    25,
+      16,    47,    15,    49,    17,    48,    32,    50,    86,    25,
+      36,    37,    38,    39,    31,     4,    32,    46,     7,     7,
+      46,    47,    11,    49,    13,    27,    72,    11,    74,    11,
+      46,    15,   110,    17,     9,    10,    25,    26,    31,    85,
+      83,    84,    31,    32,    73,    32,    72,    73,    74,     4,
+      25,    26,     7,    28,    29,    17,    31,    73,    13,    85,
+     106,     8,   108,    25,    26,     8,    10,     9,    10,    16,
+      25,    26,    18,    16,     9,    21,    31,    32,    24,     9,
+     106,     7,   108,    25,    26,    11,    28,    29,    12,    31,
+      25,    26,    16,    28,    29,    12,    31,    19,    20,    31,
+      22,    23,     7,    77,    78,    79,    80,    25,    26,     3,
+       4,     7,     5,     6,    75,    76,    81,    82,    15,    11,
+      15,     8,     8,    12,    12,     8,    30,     9,     2,    14,
+      32,    32,    32,   109,    14
+  };
+
+  const signed char
+  CalcParser::yystos_[] =
+  {
+       0,    27,    34,    35,    31,     0,    35,    36,     7,    31,
+      53,    54,    11,     8,    16,    32,     9,    54,    12,     9,
+      25,    26,    28,    29,    31,    37,    38,    40,    41,    42,
+      51,    10,    39,    31,    51,    51,     7,     7,    11,    17,
+      10,    40,    15,    15,    25,    26,    37,    11,     4,     7,
+      13,    31,    32,    42,    43,    44,    45,    46,    47,    48,
+      49,    50,    51,    43,    43,    43,    10,    43,    50,    51,
+      43,    50,     7,     8,    18,    21,    24,    19,    20,    22,
+      23,     3,     4,     5,     6,    17,     8,    12,    12,     8,
+      43,    55,    40,    43,    47,    47,    48,    48,    48,    48,
+      49,    49,    50,    50,    43,    38,    17,     8,    16,    14,
+      30,    11,    43,    43,    45,    38,    32,    52,    12,    16,
+      32
+  };
+
+  const signed char
+  CalcParser::yyr1_[] =
+  {
+       0,    33,    34,    34,    36,    35,    37,    37,    38,    39,
+      38,    40,    40,    40,    40,    40,    40,    41,    41,    41,
+      41,    41,    42,    42,    42,    42,    43,    43,    44,    45,
+      45,    46,    46,    46,    47,    47,    47,    47,    47,    48,
+      48,    48,    49,    49,    49,    50,    50,    50,    50,    50,
+      50,    50,    51,    51,    52,    52,    52,    53,    53,    53,
+      54,    54,    55,    55,    55
+  };
+
+  const signed char
+  CalcParser::yyr2_[] =
+  {
+       0,     2,     1,     2,     0,     9,     1,     2,     2,     0,
+       4,     1,     5,     7,     5,     2,     2,     1,     3,     8,
+       6,     4,     2,     2,     2,     2,     1,     1,     3,     1,
+       5,     1,     3,     3,     1,     3,     3,     3,     3,     1,
+       3,     3,     1,     3,     3,     3,     2,     2,     1,     4,
+       1,     1,     1,     4,     0,     1,     3,     0,     1,     3,
+       1,     4,     0,     1,     3
+  };
+
+
+#if YYDEBUG || 1
+  // YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+  // First, the terminals, then, starting at \a YYNTOKENS, nonterminals.
+  const char*
+  const CalcParser::yytname_[] =
+  {
+  "END", "error", "\"invalid token\"", "\"+\"", "\"-\"", "\"*\"", "\"/\"",
+  "\"(\"", "\")\"", "\"{\"", "\"}\"", "\"[\"", "\"]\"", "\"!\"", "\":\"",
+  "\";\"", "\",\"", "\"=\"", "\"?\"", "\">\"", "\"<\"", "\"==\"", "\">=\"",
+  "\"<=\"", "\"!=\"", "\"++\"", "\"--\"", "\"function\"", "\"while\"",
+  "\"if\"", "\"else\"", "\"name\"", "\"number\"", "$accept", "functions",
+  "function", "$@1", "statements", "block", "$@2", "statement",
+  "initialization", "inc_dec", "any_expr", "assign", "ternary", "equality",
+  "comparison", "expr", "term", "prim", "modifiable", "init_list",
+  "func_def_args", "def_modifiable", "func_call_args", YY_NULLPTR
+  };
+#endif
+
+
+#if YYDEBUG
+  const short
+  CalcParser::yyrline_[] =
+  {
+       0,    82,    82,    83,    86,    86,   111,   112,   120,   123,
+     123,   132,   133,   139,   145,   151,   152,   155,   168,   181,
+     203,   216,   234,   240,   246,   252,   260,   261,   264,   272,
+     273,   281,   282,   288,   296,   297,   303,   309,   315,   323,
+     324,   330,   338,   339,   345,   353,   354,   360,   366,   370,
+     380,   381,   384,   391,   404,   405,   409,   415,   416,   420,
+     426,   429,   440,   441,   445
+  };
+
+  void
+  CalcParser::yy_stack_print_ () const
+  {
+    *yycdebug_ << "Stack now";
+    for (stack_type::const_iterator
+           i = yystack_.begin (),
+           i_end = yystack_.end ();
+         i != i_end; ++i)
+      *yycdebug_ << ' ' << int (i->state);
+    *yycdebug_ << '\n';
+  }
+
+  void
+  CalcParser::yy_reduce_print_ (int yyrule) const
+  {
+    int yylno = yyrline_[yyrule];
+    int yynrhs = yyr2_[yyrule];
+    // Print the symbols being reduced, and their result.
+    *yycdebug_ << "Reducing stack by rule " << yyrule - 1
+               << " (line " << yylno << "):\n";
+    // The symbols being reduced.
+    for (int yyi = 0; yyi < yynrhs; yyi++)
+      YY_SYMBOL_PRINT ("   $" << yyi + 1 << " =",
+                       yystack_[(yynrhs) - (yyi + 1)]);
+  }
+#endif // YYDEBUG
+
+
+} // yy
+#line 2027 "CalcParser.tab.cc"
+
+#line 450 "CalcParser.yy"
+
+
+void yy::CalcParser::error (const location_type& l,  const std::string& m)
+{
+	driver.error(l, m);
+}
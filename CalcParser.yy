@@ -1,11 +1,10 @@
 %skeleton "lalr1.cc"
-%require "3.0.4"
+%require "3.6"
 %defines
-%define parser_class_name {CalcParser}
+%define api.parser.class {CalcParser}
 
 %define api.token.constructor
 %define api.value.type variant
-%define parse.assert
 
 %code requires
 {
@@ -67,14 +66,15 @@ class ParserDriver;
 	ELSE "else"
 ;
 
-%token <std::string> NAME "name"
+%token <unsigned int> NAME "name"
 %token <double> NUMBER "number"
 
 %type <IASTNode*> prim term expr comparison equality ternary assign statement statements 
 	block modifiable def_modifiable inc_dec initialization any_expr
 %type <std::list<IASTNode*>*> func_call_args func_def_args
-%type <std::list<double>*> init_list
+%type <std::vector<double>*> init_list
 
+%printer { yyoutput << driver.names.name($$); } NAME;
 %printer { yyoutput << $$; } <*>;
 
 %%
@@ -84,26 +84,27 @@ functions:
 	;
 function:
 	FUNC NAME { 
-		std::map<std::string, unsigned int> temp;
-		driver.sym_table_stack.push_back(temp); 
+		driver.scopes.open();
+		driver.array_lengths.clear();
 	} LPAREN func_def_args RPAREN LCURVEPAREN statements RCURVEPAREN {
 		ParserFunc* pf = new ParserFunc;
-		pf->name = $2;
+		pf->name = driver.names.name($2);
 		while (!$5->empty()) {
 			pf->arg.push_back($5->front());
 			$5->pop_front();
 		}
 		delete $5;
 		pf->body = $8;
+		pf->array_lengths = driver.array_lengths;
 		if (0 == driver.functable.put(pf)) {
 			driver.error("Function appears second time");
 		}
 		
 		// check is result exist
-		std::map<std::string, unsigned int> last = driver.sym_table_stack.back();
-		if (!last.count("result")) driver.error("Function '" + $2 + "' is not returning result");
+		if (!driver.scopes.local(driver.names.intern("result")))
+			driver.error("Function '" + driver.names.name($2) + "' is not returning result");
 		
-		driver.sym_table_stack.pop_back();
+		driver.scopes.close();
 	}
 	;
 statements:
@@ -111,6 +112,7 @@ statements:
 	| statements statement { 
 		ASTNoRetBinaryOpNode* parent = new ASTNoRetBinaryOpNode(STATEMENTS);
 		parent->set($1, $2);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	;
@@ -119,11 +121,10 @@ block:
 		$$ = new ASTEmptyNode();
 	}
 	| LCURVEPAREN {
-		std::map<std::string, unsigned int> temp;
-		driver.sym_table_stack.push_back(temp); 
+		driver.scopes.open();
 	}
 	statements RCURVEPAREN {
-		driver.sym_table_stack.pop_back();
+		driver.scopes.close();
 		$$ = $3;
 	}
 	;
@@ -132,16 +133,19 @@ statement:
 	| WHILE LPAREN any_expr RPAREN statement { 
 		ASTNoRetBinaryOpNode* parent = new ASTNoRetBinaryOpNode(WHILE_CYCLE);
 		parent->set($3, $5);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	| IF LPAREN any_expr RPAREN block ELSE block { 
 		ASTNoRetTernaryOpNode* parent = new ASTNoRetTernaryOpNode(IF); 
 		parent->set($3, $5, $7);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	| IF LPAREN any_expr RPAREN block {
 		ASTNoRetTernaryOpNode* parent = new ASTNoRetTernaryOpNode(IF);
 		parent->set($3, $5, new ASTEmptyNode);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	| initialization SEMICOLON { $$ = $1; }
@@ -149,72 +153,37 @@ statement:
 	;
 initialization:
 	NAME {
-		int create_new = 1;
-		std::list<std::map<std::string, unsigned int> >::reverse_iterator it;
-		std::map<std::string, unsigned int>::iterator it_in_stack;
-		for (it = driver.sym_table_stack.rbegin(); it != driver.sym_table_stack.rend(); ++it) {
-			it_in_stack = it->find($1);
-			if (it_in_stack != it->end()) {
-				std::pair<std::string, unsigned int> sym_table_record = driver.sym_table[it_in_stack->second];
-				if (sym_table_record.second != 0) 
-					driver.error("Variable name '" + sym_table_record.first + "' the same as array name");
-				create_new = 0;
-				break;
-			}
-		}
-		if (create_new) {
-			driver.sym_table_stack.back()[$1] = driver.last_index;
-			driver.sym_table[driver.last_index] = make_pair($1, 0);
+		const ScopeTable::Symbol* symbol = driver.scopes.find($1);
+		if (symbol != NULL) {
+			if (symbol->size != 0) 
+				driver.error("Variable name '" + driver.names.name($1) + "' the same as array name");
+			$$ = new ASTLeafVar(symbol->id);
+		} else {
 			ASTAssignNode* parent = new ASTAssignNode();
-			parent->set(new ASTLeafVar(driver.last_index++), new ASTLeafNum(0.0));
+			parent->set(new ASTLeafVar(driver.declare($1, 0, false).id), new ASTLeafNum(0.0));
+			parent->set_location(@$);
 			$$ = parent;
-		} else {
-			$$ = new ASTLeafVar(it_in_stack->second);
 		}
 	}
 	| NAME ASSIGN any_expr {
-		int create_new = 1;
-		ASTLeafVar* left;
-		std::list<std::map<std::string, unsigned int> >::reverse_iterator it;
-		std::map<std::string, unsigned int>::iterator it_in_stack;
-		for (it = driver.sym_table_stack.rbegin(); it != driver.sym_table_stack.rend(); ++it) {
-			it_in_stack = it->find($1);
-			if (it_in_stack != it->end()) {
-				std::pair<std::string, unsigned int> sym_table_record = driver.sym_table[it_in_stack->second];
-				if (sym_table_record.second != 0) 
-					driver.error("Variable name '" + sym_table_record.first + "' the same as array name");
-				create_new = 0;
-				break;
-			}
-		}
-		if (create_new) {
-			driver.sym_table_stack.back()[$1] = driver.last_index;
-			driver.sym_table[driver.last_index] = make_pair($1, 0);
-			left = new ASTLeafVar(driver.last_index++);
+		const ScopeTable::Symbol* symbol = driver.scopes.find($1);
+		if (symbol != NULL) {
+			if (symbol->size != 0) 
+				driver.error("Variable name '" + driver.names.name($1) + "' the same as array name");
 		} else {
-			left = new ASTLeafVar(it_in_stack->second);
+			symbol = &driver.declare($1, 0, false);
 		}
 		ASTAssignNode* parent = new ASTAssignNode();
-		parent->set(left, $3);
+		parent->set(new ASTLeafVar(symbol->id), $3);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	| NAME LSQUAREPAREN any_expr RSQUAREPAREN ASSIGN LSQUAREPAREN init_list RSQUAREPAREN {
-		int create_new = 1;
-		IASTNode* left;
-		std::list<std::map<std::string, unsigned int> >::reverse_iterator it;
-		std::map<std::string, unsigned int>::iterator it_in_stack;
-		for (it = driver.sym_table_stack.rbegin(); it != driver.sym_table_stack.rend(); ++it) {
-			it_in_stack = it->find($1);
-			if (it_in_stack != it->end()) {
-				std::pair<std::string, unsigned int> sym_table_record = driver.sym_table[it_in_stack->second];
-				if (sym_table_record.second == 0) 
-					driver.error("Variable name '" + sym_table_record.first + "' the same as array name");
-				create_new = 0;
-				break;
-			}
-		}
-		if (create_new == 0 && it == driver.sym_table_stack.rbegin()) {
-			driver.error("Array double initialization");
+		const ScopeTable::Symbol* symbol = driver.scopes.find($1);
+		if (symbol != NULL) {
+			if (symbol->size == 0) 
+				driver.error("Variable name '" + driver.names.name($1) + "' the same as array name");
+			if (driver.scopes.local($1)) driver.error("Array double initialization");
 		}
 		if ($3->get_op() != NUMBER) driver.error("Array initialization with unknown size");
 		double number = dynamic_cast<ASTLeafNum*>($3)->get();
@@ -222,80 +191,41 @@ initialization:
 		if (number < 1.0) driver.error("Array size less than 1");
 		if (number > 1e9) driver.error("Array size too big");
 		unsigned int array_size = static_cast<unsigned int>(number);
-		driver.sym_table_stack.back()[$1] = driver.last_index;
-		driver.sym_table[driver.last_index] = make_pair($1, array_size);
-		
-		// make initialization
+		const ScopeTable::Symbol& array = driver.declare($1, array_size, true);
+		if ($7->size() > array_size) driver.error("Init list too long");
 		
-		left = new ASTEmptyNode();
-		
-		unsigned int position = 0;
-		while (!$7->empty()) {
-			ASTIndexNode* index = new ASTIndexNode();
-			if (position >= array_size) driver.error("Init list too long");
-			index->set(new ASTLeafVar(driver.last_index), new ASTLeafNum(position++));
-			ASTAssignNode* parent = new ASTAssignNode();
-			parent->set(index, new ASTLeafNum($7->front()));
-			$7->pop_front();		
-			ASTNoRetBinaryOpNode* statement = new ASTNoRetBinaryOpNode(STATEMENTS);
-			statement->set(left, parent);
-			left = statement;
-		}
+		ASTArrayInitNode* init = new ASTArrayInitNode(new ASTLeafVar(array.id, array.slot));
+		init->values().swap(*$7);
 		delete $7;
-		driver.last_index++;
-		$$ = left;
+		init->set_location(@$);
+		$$ = init;
 	}
 	| NAME LSQUAREPAREN any_expr RSQUAREPAREN ASSIGN any_expr {
-		int create_new = 1;
-		IASTNode* left;
-		std::list<std::map<std::string, unsigned int> >::reverse_iterator it;
-		std::map<std::string, unsigned int>::iterator it_in_stack;
-		for (it = driver.sym_table_stack.rbegin(); it != driver.sym_table_stack.rend(); ++it) {
-			it_in_stack = it->find($1);
-			if (it_in_stack != it->end()) {
-				std::pair<std::string, unsigned int> sym_table_record = driver.sym_table[it_in_stack->second];
-				if (sym_table_record.second == 0) 
-					driver.error("Variable name '" + sym_table_record.first + "' the same as array name");
-				create_new = 0;
-				break;
-			}
-		}
-		if (create_new) {
-			driver.error("Array '" + $1 + "' not initialized");
-		} else {
-			ASTIndexNode* index = new ASTIndexNode();
-			index->set(new ASTLeafVar(it_in_stack->second), $3);
-			left = index;
-		}
+		const ScopeTable::Symbol* symbol = driver.scopes.find($1);
+		if (symbol == NULL) driver.error("Array '" + driver.names.name($1) + "' not initialized");
+		if (symbol->size == 0) 
+			driver.error("Variable name '" + driver.names.name($1) + "' the same as array name");
+		ASTIndexNode* index = new ASTIndexNode();
+		index->set(new ASTLeafVar(symbol->id, symbol->slot), $3);
+		index->set_slot(symbol->slot);
 		ASTAssignNode* parent = new ASTAssignNode();
-		parent->set(left, $6);
+		parent->set(index, $6);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	| NAME LSQUAREPAREN any_expr RSQUAREPAREN {
-		int create_new = 1;
-		std::list<std::map<std::string, unsigned int> >::reverse_iterator it;
-		std::map<std::string, unsigned int>::iterator it_in_stack;
-		for (it = driver.sym_table_stack.rbegin(); it != driver.sym_table_stack.rend(); ++it) {
-			it_in_stack = it->find($1);
-			if (it_in_stack != it->end()) {
-				std::pair<std::string, unsigned int> sym_table_record = driver.sym_table[it_in_stack->second];
-				if (sym_table_record.second == 0) 
-					driver.error("Variable name '" + sym_table_record.first + "' the same as array name");
-				create_new = 0;
-				break;
-			}
-		}
-		if (create_new == 0 && it == driver.sym_table_stack.rbegin()) {
-			driver.error("Array double initialization");
+		const ScopeTable::Symbol* symbol = driver.scopes.find($1);
+		if (symbol != NULL) {
+			if (symbol->size == 0) 
+				driver.error("Variable name '" + driver.names.name($1) + "' the same as array name");
+			if (driver.scopes.local($1)) driver.error("Array double initialization");
 		}
 		if ($3->get_op() != NUMBER) driver.error("Array initialization with unknown size");
 		double number = dynamic_cast<ASTLeafNum*>($3)->get();
 		delete $3;
 		if (number < 1.0) driver.error("Array size less than 1");
 		if (number > 1e9) driver.error("Array size too big");
-		unsigned int array_size = static_cast<unsigned int>(number);
-		driver.sym_table_stack.back()[$1] = driver.last_index;
-		driver.sym_table[driver.last_index++] = make_pair($1, array_size);
+		driver.declare($1, static_cast<unsigned int>(number), true);
 		
 		$$ = new ASTEmptyNode();
 	}
@@ -304,21 +234,25 @@ inc_dec:
 	modifiable INC { 
 		ASTIncrOpNode* parent = new ASTIncrOpNode(POST_INC);
 		parent->set($1);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	| modifiable DEC {
 		ASTIncrOpNode* parent = new ASTIncrOpNode(POST_DEC);
 		parent->set($1);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	| INC modifiable {
 		ASTIncrOpNode* parent = new ASTIncrOpNode(PRE_INC);
 		parent->set($2);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	| DEC modifiable {
 		ASTIncrOpNode* parent = new ASTIncrOpNode(PRE_DEC);
 		parent->set($2);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	;
@@ -330,6 +264,7 @@ assign:
 	modifiable ASSIGN any_expr {
 		ASTAssignNode* parent = new ASTAssignNode();
 		parent->set($1, $3);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	;
@@ -338,6 +273,7 @@ ternary:
 	| equality QUESTION any_expr COLON ternary { 
 		ASTTernaryOpNode* parent = new ASTTernaryOpNode(TERNARY);
 		parent->set($1, $3, $5);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	;
@@ -346,11 +282,13 @@ equality:
 	| equality EQUAL comparison { 
 		ASTBinaryOpNode* parent = new ASTBinaryOpNode(EQUALITY);
 		parent->set($1, $3);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	| equality NOTEQUAL comparison { 
 		ASTBinaryOpNode* parent = new ASTBinaryOpNode(NEQUALITY);
 		parent->set($1, $3);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	;
@@ -359,21 +297,25 @@ comparison:
 	| comparison LESS expr { 
 		ASTBinaryOpNode* parent = new ASTBinaryOpNode(LESS);
 		parent->set($1, $3);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	| comparison LESSEQUAL expr { 
 		ASTBinaryOpNode* parent = new ASTBinaryOpNode(LESS_EQUAL);
 		parent->set($1, $3);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	| comparison GREATER expr { 
 		ASTBinaryOpNode* parent = new ASTBinaryOpNode(GREATER);
 		parent->set($1, $3);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	| comparison GREATEREQUAL expr { 
 		ASTBinaryOpNode* parent = new ASTBinaryOpNode(GREATER_EQUAL);
 		parent->set($1, $3);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	;
@@ -382,11 +324,13 @@ expr:
 	| expr ADD term { 
 		ASTBinaryOpNode* parent = new ASTBinaryOpNode(ADD);
 		parent->set($1, $3);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	| expr SUB term { 
 		ASTBinaryOpNode* parent = new ASTBinaryOpNode(SUB);
 		parent->set($1, $3);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	;
@@ -395,11 +339,13 @@ term:
 	| term MUL prim { 
 		ASTBinaryOpNode* parent = new ASTBinaryOpNode(MUL);
 		parent->set($1, $3);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	| term DIV prim { 
 		ASTBinaryOpNode* parent = new ASTBinaryOpNode(DIV);
 		parent->set($1, $3);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	;
@@ -408,21 +354,27 @@ prim:
 	| SUB prim { 
 		ASTUnaryOpNode* parent = new ASTUnaryOpNode(UNARY_MINUS);
 		parent->set($2);
+		parent->set_location(@$);
 		$$ = parent;
 	}
 	| NOT prim { 
 		ASTUnaryOpNode* parent = new ASTUnaryOpNode(NOT);
 		parent->set($2);
+		parent->set_location(@$);
 		$$ = parent;
 	}
-	| NUMBER { $$ = new ASTLeafNum($1); }
+	| NUMBER {
+		$$ = new ASTLeafNum($1);
+		$$->set_location(@$);
+	}
 	| NAME LPAREN func_call_args RPAREN {
-		ASTFuncCallNode* func = new ASTFuncCallNode($1);
+		ASTFuncCallNode* func = new ASTFuncCallNode(driver.names.name($1));
 		while (!$3->empty()) {
 			func->set_args($3->front());
 			$3->pop_front();
 		}
 		delete $3;
+		func->set_location(@$);
 		$$ = func;
 	}
 	| modifiable { $$ = $1; }
@@ -430,49 +382,28 @@ prim:
 	;
 modifiable:
 	NAME {
-		int create_new = 1;
-		std::list<std::map<std::string, unsigned int> >::reverse_iterator it;
-		std::map<std::string, unsigned int>::iterator it_in_stack;
-		for (it = driver.sym_table_stack.rbegin(); it != driver.sym_table_stack.rend(); ++it) {
-			it_in_stack = it->find($1);
-			if (it_in_stack != it->end()) {
-				create_new = 0;
-				break;
-			}
-		}
-		if (create_new) {
-			driver.error("Variable '" + $1 + "' not found");
-		} else {
-			$$ = new ASTLeafVar(it_in_stack->second);
-		}
+		const ScopeTable::Symbol* symbol = driver.scopes.find($1);
+		if (symbol == NULL) driver.error("Variable '" + driver.names.name($1) + "' not found");
+		// array name is allowed as function argument
+		$$ = new ASTLeafVar(symbol->id, symbol->slot);
+		$$->set_location(@$);
 	}
 	| NAME LSQUAREPAREN any_expr RSQUAREPAREN {
-		int create_new = 1;
-		std::list<std::map<std::string, unsigned int> >::reverse_iterator it;
-		std::map<std::string, unsigned int>::iterator it_in_stack;
-		for (it = driver.sym_table_stack.rbegin(); it != driver.sym_table_stack.rend(); ++it) {
-			it_in_stack = it->find($1);
-			if (it_in_stack != it->end()) {
-				std::pair<std::string, unsigned int> sym_table_record = driver.sym_table[it_in_stack->second];
-				if (sym_table_record.second == 0)
-					driver.error("Variable name '" + sym_table_record.first + "' the same as array name");
-				create_new = 0;
-				break;
-			}
-		}
-		if (create_new) {
-			driver.error("Array '" + $1 + "' not found");
-		} else {
-			ASTIndexNode* index = new ASTIndexNode();
-			index->set(new ASTLeafVar(it_in_stack->second), $3);
-			$$ = index;
-		}
+		const ScopeTable::Symbol* symbol = driver.scopes.find($1);
+		if (symbol == NULL) driver.error("Array '" + driver.names.name($1) + "' not found");
+		if (symbol->size == 0)
+			driver.error("Variable name '" + driver.names.name($1) + "' the same as array name");
+		ASTIndexNode* index = new ASTIndexNode();
+		index->set(new ASTLeafVar(symbol->id, symbol->slot), $3);
+		index->set_slot(symbol->slot);
+		index->set_location(@$);
+		$$ = index;
 	}
 	;
 init_list:
-	/* empty */ { $$ = new std::list<double>; }
+	/* empty */ { $$ = new std::vector<double>; }
 	| NUMBER { 
-		$$ = new std::list<double>; 
+		$$ = new std::vector<double>; 
 		$$->push_back($1);
 	}
 	| init_list COMMA NUMBER { 
@@ -493,18 +424,15 @@ func_def_args:
 	;
 def_modifiable:
 	NAME {
-		driver.sym_table_stack.back()[$1] = driver.last_index;
-		driver.sym_table[driver.last_index] = make_pair($1, 0);
-		$$ = new ASTLeafVar(driver.last_index++);
+		$$ = new ASTLeafVar(driver.declare($1, 0, false).id);
 	}
 	| NAME LSQUAREPAREN NUMBER RSQUAREPAREN {
 		if ($3 < 0.0) driver.error("Array size less than zero");
 		if ($3 > 1e9) driver.error("Array size too big");
-		unsigned int array_size = static_cast<unsigned int>($3);
-		driver.sym_table_stack.back()[$1] = driver.last_index;
-		driver.sym_table[driver.last_index] = make_pair($1, array_size);
+		const ScopeTable::Symbol& array = driver.declare($1, static_cast<unsigned int>($3), true);
 		ASTIndexNode* index = new ASTIndexNode();
-		index->set(new ASTLeafVar(driver.last_index++), new ASTLeafNum($3));
+		index->set(new ASTLeafVar(array.id, array.slot), new ASTLeafNum($3));
+		index->set_slot(array.slot);
 		$$ = index;
 	}
 	;
@@ -0,0 +1,108 @@
+// shows live metrics of running interpreters started with --live, built by 'make calc-top'
+// usage: ./calc-top [pid] [interval_ms]
+
+#include <dirent.h>
+#include <signal.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "LiveMetrics.h"
+
+static void usage()
+{
+	std::cout << "Usage: ./calc-top [pid] [interval_ms]\n";
+	std::cout << "\twithout pid all interpreters are shown once\n";
+	exit(-1);
+}
+
+// pids of segments in /dev/shm
+static std::vector<unsigned long long> find_processes()
+{
+	std::vector<unsigned long long> pids;
+	DIR* dir = opendir("/dev/shm");
+	if (dir == NULL) return pids;
+	dirent* entry;
+	while ((entry = readdir(dir)) != NULL) {
+		if (strncmp(entry->d_name, "calc.", 5) != 0) continue;
+		pids.push_back(strtoull(entry->d_name + 5, NULL, 10));
+	}
+	closedir(dir);
+	return pids;
+}
+
+// process crashed if it doesn't exist and didn't publish final snapshot
+static int exists(unsigned long long pid)
+{
+	return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+static void print_header()
+{
+	printf("%8s %10s %14s %12s %12s %6s %12s  %s\n", "pid", "time s", "steps", "steps/s", "calls", "depth", "array peak", "function");
+}
+
+static void print_snapshot(const LiveMetrics::Block& block)
+{
+	printf("%8llu %10.2f %14llu %12llu %12llu %6llu %12llu  %s%s\n", block.pid,
+		(block.update_ns - block.start_ns) / 1e9, block.steps, block.steps_per_second,
+		block.calls, block.depth, block.array_bytes, block.function, block.finished ? " (finished)" : "");
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 3) usage();
+	if (argc == 1) {
+		std::vector<unsigned long long> pids = find_processes();
+		print_header();
+		for (unsigned int i = 0; i < pids.size(); i++) {
+			std::string name = LiveMetrics::segment_name(pids[i]);
+			int alive = exists(pids[i]); // before read, process can finish between them
+			LiveMetrics::Block block;
+			if (!LiveMetrics::read(name, block)) continue;
+			if (block.finished) {
+				print_snapshot(block);
+				LiveMetrics::remove(name); // shown once
+			} else if (!alive) {
+				LiveMetrics::remove(name); // left by crashed process
+			} else {
+				print_snapshot(block);
+			}
+		}
+		return 0;
+	}
+
+	unsigned long long pid = strtoull(argv[1], NULL, 10);
+	int interval = argc == 3 ? atoi(argv[2]) : 1000;
+	if (pid == 0 || interval <= 0) usage();
+	std::string name = LiveMetrics::segment_name(pid);
+	LiveMetrics::Block block;
+	int alive = exists(pid);
+	if (!LiveMetrics::read(name, block) || (!block.finished && !alive)) {
+		std::cerr << "No interpreter with pid " << pid << " publishes metrics\n";
+		return -1;
+	}
+	print_header();
+	while (1) {
+		print_snapshot(block);
+		fflush(stdout);
+		if (block.finished) {
+			LiveMetrics::remove(name);
+			break;
+		}
+		usleep(interval * 1000);
+		alive = exists(pid);
+		if (!LiveMetrics::read(name, block)) break;
+		if (!block.finished && !alive) {
+			std::cerr << "Interpreter " << pid << " exited without finishing\n";
+			LiveMetrics::remove(name);
+			return -1;
+		}
+	}
+	return 0;
+}
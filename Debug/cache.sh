@@ -0,0 +1,33 @@
+#!/bin/bash
+
+# startup latency without program cache (cold) and with it (warm)
+# usage: ./cache.sh [program...]
+# cold ms is cache_load + parse + cache_store of first run with empty cache,
+# warm ms is cache_load of second run
+
+if [ $# -eq 0 ]; then set -- *.in; fi
+dir=`mktemp -d`
+
+phase() {
+	echo "$1" | grep -o "\"name\": \"$2\", \"wall_ms\": [0-9.]*" | awk '{ print $4 } END { if (NR == 0) print 0 }'
+}
+
+printf "%-24s %10s %10s %10s %10s %8s\n" "program" "parse ms" "store ms" "cold ms" "warm ms" "speedup"
+for prog in "$@"; do
+	mode=-i
+	case `basename $prog` in ssa*) mode=-c ;; esac
+	rm -f $dir/*
+	cold=`./calc $prog $mode -q --cache $dir --stats 2>&1 > /dev/null | grep '"phases"' | tail -1`
+	warm=`./calc $prog $mode -q --cache $dir --stats 2>&1 > /dev/null | grep '"phases"' | tail -1`
+	if [ -z "$warm" ] || echo "$warm" | grep -q '"name": "parse"'; then
+		printf "%-24s %s\n" `basename $prog` "not cached"
+		continue
+	fi
+	parse=`phase "$cold" parse`
+	store=`phase "$cold" cache_store`
+	cold_ms=`awk -v l=$(phase "$cold" cache_load) -v p=$parse -v s=$store 'BEGIN { print l + p + s }'`
+	warm_ms=`phase "$warm" cache_load`
+	awk -v n=`basename $prog` -v p=$parse -v s=$store -v c=$cold_ms -v w=$warm_ms 'BEGIN {
+		printf "%-24s %10.3f %10.3f %10.3f %10.3f %7.1fx\n", n, p, s, c, w, (w > 0 ? p / w : 0) }'
+done
+rm -rf $dir
@@ -0,0 +1,34 @@
+#!/bin/bash
+
+# time to first result of generated libraries of growing size whose main calls one function,
+# eager parsing against --lazy
+# usage: ./lazy.sh count... [-- generator options]
+# example: ./lazy.sh 100 1000 10000 100000 -- -s 40
+# lazy ms should stay nearly flat while eager ms grows with size of library
+
+if [ $# -lt 1 ]; then
+	echo "usage: ./lazy.sh count... [-- generator options]"
+	exit 2
+fi
+counts=""
+while [ $# -gt 0 ] && [ "$1" != "--" ]; do
+	counts="$counts $1"
+	shift
+done
+if [ "$1" == "--" ]; then shift; fi
+
+field() {
+	echo "$1" | grep -o "\"$2\": [0-9.]*" | head -1 | awk '{ print $2 } END { if (NR == 0) print 0 }'
+}
+
+program=`mktemp`
+printf "%10s %10s %10s %10s %8s\n" "functions" "bytes" "eager ms" "lazy ms" "speedup"
+for count in $counts; do
+	./gen "$@" -f $count -o 0 > $program
+	bytes=`wc -c < $program`
+	eager=`./calc $program -i -q --stats 2>&1 > /dev/null | grep '"phases"' | tail -1`
+	lazy=`./calc $program -i -q --lazy --stats 2>&1 > /dev/null | grep '"phases"' | tail -1`
+	awk -v c=$count -v b=$bytes -v e=`field "$eager" total_ms` -v l=`field "$lazy" total_ms` 'BEGIN {
+		printf "%10d %10d %10.3f %10.3f %7.1fx\n", c, b, e, l, (l > 0 ? e / l : 0) }'
+done
+rm -f $program
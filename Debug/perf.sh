@@ -0,0 +1,98 @@
+#!/bin/bash
+
+# performance regression check of all tests in -i and -c modes
+# usage: ./perf.sh [-n runs] [-b baseline] [-u] [-t percent] [-r percent] [-a ms]
+#	-n runs		runs of every test, median is compared (default 5)
+#	-b file		baseline (default perf.baseline)
+#	-u		write measured values to baseline instead of comparing
+#	-t percent	allowed growth of wall and CPU (user + sys) time (default 10)
+#	-r percent	allowed growth of max RSS (default 10)
+#	-a ms		time growth below ms is never a regression (default 5),
+#			kernel splits CPU time between user and sys in scheduler ticks
+# baseline line: test mode wall_ms user_ms sys_ms max_rss_kb
+
+runs=5
+baseline=perf.baseline
+update=0
+time_tol=10
+rss_tol=10
+abs_ms=5
+while getopts "n:b:ut:r:a:" opt; do
+	case $opt in
+	n) runs=$OPTARG ;;
+	b) baseline=$OPTARG ;;
+	u) update=1 ;;
+	t) time_tol=$OPTARG ;;
+	r) rss_tol=$OPTARG ;;
+	a) abs_ms=$OPTARG ;;
+	*) exit 2 ;;
+	esac
+done
+
+if [ $update -eq 0 ] && [ ! -f $baseline ]; then
+	echo "baseline $baseline not found, create it with -u"
+	exit 2
+fi
+
+# value of numeric field of --stats line
+field() {
+	echo "$1" | grep -o "\"$2\": [0-9.]*" | awk '{ print $2 } END { if (NR == 0) print 0 }'
+}
+
+median() {
+	sort -g | awk '{ v[NR] = $1 } END { print v[int((NR + 1) / 2)] }'
+}
+
+measured=`mktemp`
+for f in `ls *.in | sort -V`; do
+	name=${f%.in}
+	for mode in -i -c; do
+		rm -f perf.runs
+		for n in `seq 1 $runs`; do
+			start=`date +%s.%N`
+			stats=`./calc $f $mode -q --stats 2>&1 > /dev/null | grep '"phases"' | tail -1`
+			end=`date +%s.%N`
+			wall=`awk -v s=$start -v e=$end 'BEGIN { printf "%.3f", (e - s) * 1000 }'`
+			echo "$wall `field "$stats" user_ms` `field "$stats" sys_ms` `field "$stats" max_rss_kb`" >> perf.runs
+		done
+		line="$name $mode"
+		for col in 1 2 3 4; do
+			line="$line `awk -v c=$col '{ print $c }' perf.runs | median`"
+		done
+		echo "$line" >> $measured
+	done
+done
+rm -f perf.runs
+
+if [ $update -eq 1 ]; then
+	mv $measured $baseline
+	echo "baseline written to $baseline"
+	exit 0
+fi
+
+awk -v time_tol=$time_tol -v rss_tol=$rss_tol -v abs_ms=$abs_ms '
+	function delta(new, old) { return old > 0 ? sprintf("%+.1f%%", (new - old) * 100 / old) : "-" }
+	function slower(new, old) { return new > old * (1 + time_tol / 100) && new - old > abs_ms }
+	NR == FNR { base[$1 " " $2] = $0; next }
+	{
+		key = $1 " " $2
+		if (!(key in base)) {
+			printf "%-10s %s %10.3f %9s %10.3f %9s %10.3f %9s %9d %9s  new\n", $1, $2, $3, "-", $4, "-", $5, "-", $6, "-"
+			next
+		}
+		split(base[key], b, " ")
+		status = "ok"
+		if (slower($3, b[3]) || slower($4 + $5, b[4] + b[5])) status = "SLOWER"
+		if ($6 > b[6] * (1 + rss_tol / 100)) status = (status == "ok" ? "" : status ",") "MORE MEMORY"
+		if (status != "ok") failed++
+		printf "%-10s %s %10.3f %9s %10.3f %9s %10.3f %9s %9d %9s  %s\n", $1, $2, $3, delta($3, b[3]), $4, delta($4, b[4]), $5, delta($5, b[5]), $6, delta($6, b[6]), status
+	}
+	BEGIN { printf "%-10s %s %10s %9s %10s %9s %10s %9s %9s %9s  %s\n", "test", "mode", "wall ms", "delta", "user ms", "delta", "sys ms", "delta", "rss kb", "delta", "status" }
+	END {
+		print failed + 0 " regressions"
+		exit failed > 0
+	}
+' $baseline $measured
+res=$?
+rm -f $measured
+exit $res
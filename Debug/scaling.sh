@@ -0,0 +1,48 @@
+#!/bin/bash
+
+# time and memory of generated programs of growing size
+# usage: ./scaling.sh option value... [-- generator options]
+# example: ./scaling.sh -f 100 200 400 800 -- -s 40 -d 3
+# exponent column is log(time ratio) / log(size ratio) between neighbour rows,
+# values near 1 are linear, 2 quadratic
+
+if [ $# -lt 2 ]; then
+	echo "usage: ./scaling.sh option value... [-- generator options]"
+	exit 2
+fi
+option=$1
+shift
+values=""
+while [ $# -gt 0 ] && [ "$1" != "--" ]; do
+	values="$values $1"
+	shift
+done
+if [ "$1" == "--" ]; then shift; fi
+
+# value of numeric field of --stats line
+field() {
+	echo "$1" | grep -o "\"$2\": [0-9.]*" | head -1 | awk '{ print $2 } END { if (NR == 0) print 0 }'
+}
+phase() {
+	echo "$1" | grep -o "\"name\": \"$2\", \"wall_ms\": [0-9.]*" | awk '{ print $4 } END { if (NR == 0) print 0 }'
+}
+
+program=`mktemp`
+printf "%10s %10s %10s %12s %10s %10s %10s  %s\n" "$option" "bytes" "parse ms" "interpret ms" "total ms" "rss kb" "exponent" "status"
+prev_value=""
+for value in $values; do
+	./gen "$@" $option $value > $program
+	bytes=`wc -c < $program`
+	stats=`./calc $program -i -q --stats 2>&1 > /dev/null | grep '"phases"' | tail -1`
+	status=`echo "$stats" | grep -o '"status": "[^"]*"' | cut -d '"' -f 4`
+	parse=`phase "$stats" parse`
+	interpret=`phase "$stats" interpret`
+	total=`field "$stats" total_ms`
+	rss=`field "$stats" max_rss_kb`
+	exponent=`awk -v v=$value -v pv=$prev_value -v t=$total -v pt=$prev_total 'BEGIN {
+		if (pv == "" || pv == v || pt <= 0 || t <= 0) print "-"; else printf "%.2f", log(t / pt) / log(v / pv) }'`
+	printf "%10s %10d %10.3f %12.3f %10.3f %10d %10s  %s\n" $value $bytes $parse $interpret $total $rss $exponent "${status:-crashed}"
+	prev_value=$value
+	prev_total=$total
+done
+rm -f $program
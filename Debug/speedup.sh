@@ -0,0 +1,16 @@
+#!/bin/bash
+
+# time of parallel evaluation for 1..max threads
+# usage: ./speedup.sh [max_threads] [program]
+max=${1:-`nproc`}
+prog=${2:-bench_fib.in}
+
+echo "threads time speedup"
+for j in `seq 1 $max`; do
+	start=`date +%s.%N`
+	./calc $prog -i -q -j $j > /dev/null
+	end=`date +%s.%N`
+	t=`awk -v s=$start -v e=$end 'BEGIN { printf "%.3f", e - s }'`
+	if [ $j -eq 1 ]; then base=$t; fi
+	awk -v j=$j -v t=$t -v b=$base 'BEGIN { printf "%d %.3f %.2f\n", j, t, b / t }'
+done
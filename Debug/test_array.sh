@@ -0,0 +1,27 @@
+#!/bin/bash
+
+# elements at power of two stride stay in hash table of large array, it must be filled
+# about as fast as dense array, which moves to pages
+ms() { echo $(( $(date +%s%N) / 1000000 )); }
+
+./calc array_stride.in -i | tail -1 > array_stride.out.test
+if ! diff array_stride.out array_stride.out.test > ast.log; then
+	echo "array_stride FAILED"
+	rm array_stride.out.test
+	exit 1
+fi
+rm array_stride.out.test
+
+sed 's/\* 4096/* 1/' array_stride.in > array_dense.in
+start=`ms`
+./calc array_dense.in -i -q
+dense=$(( `ms` - start ))
+start=`ms`
+./calc array_stride.in -i -q
+sparse=$(( `ms` - start ))
+rm array_dense.in
+if [ $sparse -gt $(( 2 * dense )) ]; then
+	echo "array_stride FAILED: $sparse ms, dense array $dense ms"
+	exit 1
+fi
+echo "array_stride passed: $sparse ms, dense array $dense ms"
@@ -0,0 +1,15 @@
+#!/bin/bash
+
+# memoization must not change output
+for i in `seq 0 27`; do
+	./calc $i.in -i -m 16 > $i.out.test 2> /dev/null
+	if diff $i.out $i.out.test > ast.log; then
+		echo -n "$i passed "
+	else
+		echo -n "$i FAILED "
+		rm $i.out.test
+		break
+	fi
+	rm $i.out.test
+done
+echo ""
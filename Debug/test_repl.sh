@@ -0,0 +1,17 @@
+#!/bin/bash
+
+# definitions, replacement and errors of one session, latency goes to stderr
+# with memoization only callers of replaced function lose cached results
+for test in "repl_session.out" "repl_session_memo.out -m 16"; do
+	set -- $test
+	out=$1
+	shift
+	./calc --repl "$@" < repl_session.txt > $out.test 2> /dev/null
+	if diff $out $out.test > ast.log; then
+		echo -n "$out passed "
+	else
+		echo -n "$out FAILED "
+	fi
+	rm $out.test
+done
+echo ""
@@ -0,0 +1,24 @@
+#!/bin/bash
+
+# tokens and locations of hand-written scanner are compared with flex scanner
+# usage: ./test_scanner.sh [program...]
+if [ $# -eq 0 ]; then set -- *.in; fi
+
+scanners="scalar sse2 avx2"
+for prog in "$@"; do
+	./calc $prog -l > scanner.flex 2>&1
+	for scanner in $scanners; do
+		if ! ./calc $prog -l --scanner $scanner > scanner.fast 2>&1; then
+			if grep -q "^Usage" scanner.fast; then continue; fi # not supported by processor
+		fi
+		if diff scanner.flex scanner.fast > scanner.log; then
+			echo -n "$prog $scanner passed "
+		else
+			echo -n "$prog $scanner FAILED "
+			rm scanner.flex scanner.fast
+			exit 1
+		fi
+	done
+done
+rm -f scanner.flex scanner.fast scanner.log
+echo ""
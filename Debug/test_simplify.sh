@@ -0,0 +1,15 @@
+#!/bin/bash
+
+# simplified programs must print the same assignments
+for i in `seq 0 27` 31; do
+	./calc $i.in -i -O > $i.out.test 2> /dev/null
+	if diff $i.out $i.out.test > ast.log; then
+		echo -n "$i passed "
+	else
+		echo -n "$i FAILED "
+		rm $i.out.test
+		break
+	fi
+	rm $i.out.test
+done
+echo ""
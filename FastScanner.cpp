@@ -0,0 +1,320 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define FAST_SCANNER_X86
+#include <immintrin.h>
+#endif
+
+#include "FastScanner.h"
+#include "ParserDriver.h"
+
+// character classes, bits of char_classes
+enum { BLANK = 1, NEWLINE = 2, NAME_CHAR = 4, DIGIT = 8, NAME_START = 16 };
+
+static unsigned char char_classes[256];
+
+static int init_classes()
+{
+	char_classes[static_cast<unsigned char>(' ')] = BLANK;
+	char_classes[static_cast<unsigned char>('\t')] = BLANK;
+	char_classes[static_cast<unsigned char>('\n')] = NEWLINE;
+	char_classes[static_cast<unsigned char>('_')] = NAME_CHAR | NAME_START;
+	for (int c = 'a'; c <= 'z'; c++) char_classes[c] = char_classes[c - 'a' + 'A'] = NAME_CHAR | NAME_START;
+	for (int c = '0'; c <= '9'; c++) char_classes[c] = NAME_CHAR | DIGIT;
+	return 1;
+}
+
+static const int classes_ready = init_classes();
+
+static size_t run_scalar(const char* p, const char* end, int cls)
+{
+	const char* start = p;
+	while (p < end && (char_classes[static_cast<unsigned char>(*p)] & cls)) p++;
+	return p - start;
+}
+
+#ifdef FAST_SCANNER_X86
+
+// bytes of x in [lo, hi], unsigned
+static inline __m128i in_range_sse2(__m128i x, char lo, char hi)
+{
+	return _mm_cmpeq_epi8(_mm_min_epu8(_mm_max_epu8(x, _mm_set1_epi8(lo)), _mm_set1_epi8(hi)), x);
+}
+
+// bit i is set if byte i of x is of class cls
+static inline unsigned int mask_sse2(__m128i x, int cls)
+{
+	__m128i m;
+	if (cls == BLANK) {
+		m = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\t')));
+	} else if (cls == NEWLINE) {
+		m = _mm_cmpeq_epi8(x, _mm_set1_epi8('\n'));
+	} else if (cls == DIGIT) {
+		m = in_range_sse2(x, '0', '9');
+	} else {
+		// letters of both cases are one range with bit 0x20 set
+		m = _mm_or_si128(in_range_sse2(_mm_or_si128(x, _mm_set1_epi8(0x20)), 'a', 'z'),
+			_mm_or_si128(in_range_sse2(x, '0', '9'), _mm_cmpeq_epi8(x, _mm_set1_epi8('_'))));
+	}
+	return _mm_movemask_epi8(m);
+}
+
+static size_t run_sse2(const char* p, const char* end, int cls)
+{
+	const char* start = p;
+	for (; end - p >= 16; p += 16) {
+		unsigned int outside = ~mask_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), cls) & 0xffff;
+		if (outside != 0) return p - start + __builtin_ctz(outside);
+	}
+	return p - start + run_scalar(p, end, cls);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i in_range_avx2(__m256i x, char lo, char hi)
+{
+	return _mm256_cmpeq_epi8(_mm256_min_epu8(_mm256_max_epu8(x, _mm256_set1_epi8(lo)), _mm256_set1_epi8(hi)), x);
+}
+
+__attribute__((target("avx2")))
+static inline unsigned int mask_avx2(__m256i x, int cls)
+{
+	__m256i m;
+	if (cls == BLANK) {
+		m = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\t')));
+	} else if (cls == NEWLINE) {
+		m = _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\n'));
+	} else if (cls == DIGIT) {
+		m = in_range_avx2(x, '0', '9');
+	} else {
+		m = _mm256_or_si256(in_range_avx2(_mm256_or_si256(x, _mm256_set1_epi8(0x20)), 'a', 'z'),
+			_mm256_or_si256(in_range_avx2(x, '0', '9'), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('_'))));
+	}
+	return _mm256_movemask_epi8(m);
+}
+
+__attribute__((target("avx2")))
+static size_t run_avx2(const char* p, const char* end, int cls)
+{
+	const char* start = p;
+	for (; end - p >= 32; p += 32) {
+		unsigned int outside = ~mask_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), cls);
+		if (outside != 0) return p - start + __builtin_ctz(outside);
+	}
+	return p - start + run_sse2(p, end, cls);
+}
+
+#endif // FAST_SCANNER_X86
+
+int FastScanner::best_simd()
+{
+#ifdef FAST_SCANNER_X86
+	if (__builtin_cpu_supports("avx2")) return AVX2;
+	return SSE2;
+#else
+	return SCALAR;
+#endif
+}
+
+const char* FastScanner::simd_name(int simd)
+{
+	static const char* names[] = { "scalar", "sse2", "avx2" };
+	return names[simd];
+}
+
+int FastScanner::set_simd(int simd)
+{
+	if (simd > best_simd()) return 0;
+	m_simd = simd;
+	return 1;
+}
+
+size_t FastScanner::run(const char* p, int cls) const
+{
+#ifdef FAST_SCANNER_X86
+	if (m_simd == AVX2) return run_avx2(p, m_end, cls);
+	if (m_simd == SSE2) return run_sse2(p, m_end, cls);
+#endif
+	return run_scalar(p, m_end, cls);
+}
+
+// value of [0-9]*\.?[0-9]+ as by atof(); mantissa of at most 19 digits below 2^53
+// divided by exact power of ten is correctly rounded (Clinger's fast path)
+static double decimal_to_double(const char* text, size_t length)
+{
+	static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+		1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+	static const int max_decimals = sizeof(powers) / sizeof(powers[0]) - 1;
+	unsigned long long mantissa = 0;
+	int digits = 0; // significant
+	int decimals = -1; // after point, -1 if there is no point
+	for (size_t i = 0; i < length && digits <= 19; i++) {
+		if (text[i] == '.') {
+			decimals = 0;
+			continue;
+		}
+		if (mantissa != 0 || text[i] != '0') digits++;
+		mantissa = mantissa * 10 + (text[i] - '0');
+		if (decimals >= 0) decimals++;
+	}
+	if (decimals < 0) decimals = 0;
+#if FLT_EVAL_METHOD == 0 // no excess precision, division is rounded once
+	if (digits <= 19 && mantissa <= (1ULL << 53) && decimals <= max_decimals)
+		return static_cast<double>(mantissa) / powers[decimals];
+#endif
+	std::string copy(text, length);
+	return atof(copy.c_str());
+}
+
+void FastScanner::begin(ParserDriver& driver)
+{
+	end();
+	driver.location = yy::location();
+	int fd = driver.file == "-" ? STDIN_FILENO : open(driver.file.c_str(), O_RDONLY);
+	if (fd < 0) driver.error("Cannot open " + driver.file);
+	struct stat st;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+		void* addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (addr != MAP_FAILED) {
+			madvise(addr, st.st_size, MADV_SEQUENTIAL);
+			m_mapped = static_cast<char*>(addr);
+			m_mapped_size = st.st_size;
+		}
+	}
+	if (m_mapped == NULL) {
+		char block[1 << 16];
+		ssize_t size;
+		while ((size = read(fd, block, sizeof(block))) != 0) {
+			if (size > 0) m_buffer.append(block, size);
+			else if (errno != EINTR) break;
+		}
+		if (size < 0) {
+			if (fd != STDIN_FILENO) close(fd);
+			driver.error("Cannot read " + driver.file);
+		}
+	}
+	if (fd != STDIN_FILENO) close(fd);
+	m_pos = m_mapped != NULL ? m_mapped : m_buffer.data();
+	m_end = m_pos + (m_mapped != NULL ? m_mapped_size : m_buffer.size());
+}
+
+void FastScanner::begin(ParserDriver& driver, const char* text, size_t size)
+{
+	end();
+	driver.location = yy::location();
+	m_pos = text;
+	m_end = text + size;
+}
+
+void FastScanner::end()
+{
+	if (m_mapped != NULL) munmap(m_mapped, m_mapped_size);
+	m_mapped = NULL;
+	m_mapped_size = 0;
+	m_buffer.clear();
+	m_pos = m_end = NULL;
+}
+
+// same rules as CalcScanner.l, longest match
+yy::CalcParser::symbol_type FastScanner::next(ParserDriver& driver)
+{
+	yy::location& loc = driver.location;
+	loc.step();
+	for (;;) {
+		if (m_pos == m_end) return yy::CalcParser::make_END(loc);
+		int cls = char_classes[static_cast<unsigned char>(*m_pos)];
+		if (cls & BLANK) {
+			size_t length = run(m_pos, BLANK);
+			m_pos += length;
+			loc.columns(length);
+			loc.step();
+		} else if (cls & NEWLINE) {
+			size_t length = run(m_pos, NEWLINE);
+			m_pos += length;
+			loc.lines(length);
+			loc.step();
+		} else {
+			break;
+		}
+	}
+
+	const char* start = m_pos;
+	int cls = char_classes[static_cast<unsigned char>(*start)];
+	if (cls & NAME_START) {
+		size_t length = 1 + run(start + 1, NAME_CHAR);
+		m_pos += length;
+		loc.columns(length);
+		switch (length) {
+		case 2:
+			if (memcmp(start, "if", 2) == 0) return yy::CalcParser::make_IF(loc);
+			break;
+		case 4:
+			if (memcmp(start, "else", 4) == 0) return yy::CalcParser::make_ELSE(loc);
+			break;
+		case 5:
+			if (memcmp(start, "while", 5) == 0) return yy::CalcParser::make_WHILE(loc);
+			break;
+		case 8:
+			if (memcmp(start, "function", 8) == 0) return yy::CalcParser::make_FUNC(loc);
+			break;
+		}
+		return yy::CalcParser::make_NAME(driver.names.intern(start, length), loc);
+	}
+	int point_digit = *start == '.' && start + 1 < m_end && (char_classes[static_cast<unsigned char>(start[1])] & DIGIT);
+	if ((cls & DIGIT) || point_digit) {
+		const char* p = start + run(start, DIGIT);
+		if (p + 1 < m_end && *p == '.' && (char_classes[static_cast<unsigned char>(p[1])] & DIGIT))
+			p += 1 + run(p + 1, DIGIT);
+		m_pos = p;
+		loc.columns(p - start);
+		return yy::CalcParser::make_NUMBER(decimal_to_double(start, p - start), loc);
+	}
+
+	char second = start + 1 < m_end ? start[1] : '\0';
+	m_pos++;
+	if (second == '=' && (*start == '=' || *start == '>' || *start == '<' || *start == '!')) {
+		m_pos++;
+		loc.columns(2);
+		switch (*start) {
+		case '=': return yy::CalcParser::make_EQUAL(loc);
+		case '>': return yy::CalcParser::make_GREATEREQUAL(loc);
+		case '<': return yy::CalcParser::make_LESSEQUAL(loc);
+		default: return yy::CalcParser::make_NOTEQUAL(loc);
+		}
+	}
+	if ((*start == '+' || *start == '-') && second == *start) {
+		m_pos++;
+		loc.columns(2);
+		if (*start == '+') return yy::CalcParser::make_INC(loc);
+		return yy::CalcParser::make_DEC(loc);
+	}
+	loc.columns(1);
+	switch (*start) {
+	case '+': return yy::CalcParser::make_ADD(loc);
+	case '-': return yy::CalcParser::make_SUB(loc);
+	case '*': return yy::CalcParser::make_MUL(loc);
+	case '/': return yy::CalcParser::make_DIV(loc);
+	case '(': return yy::CalcParser::make_LPAREN(loc);
+	case ')': return yy::CalcParser::make_RPAREN(loc);
+	case '{': return yy::CalcParser::make_LCURVEPAREN(loc);
+	case '}': return yy::CalcParser::make_RCURVEPAREN(loc);
+	case '[': return yy::CalcParser::make_LSQUAREPAREN(loc);
+	case ']': return yy::CalcParser::make_RSQUAREPAREN(loc);
+	case '!': return yy::CalcParser::make_NOT(loc);
+	case ':': return yy::CalcParser::make_COLON(loc);
+	case ';': return yy::CalcParser::make_SEMICOLON(loc);
+	case ',': return yy::CalcParser::make_COMMA(loc);
+	case '=': return yy::CalcParser::make_ASSIGN(loc);
+	case '?': return yy::CalcParser::make_QUESTION(loc);
+	case '>': return yy::CalcParser::make_GREATER(loc);
+	case '<': return yy::CalcParser::make_LESS(loc);
+	}
+	driver.error(loc, "Invalid character");
+	return yy::CalcParser::make_END(loc);
+}
@@ -0,0 +1,48 @@
+#ifndef FAST_SCANNER_H
+#define FAST_SCANNER_H
+
+#include <cstddef>
+#include <string>
+
+#include "CalcParser.tab.hh"
+
+class ParserDriver;
+
+// hand-written alternative to flex scanner for large sources, returns same tokens
+// and locations; whole source is in memory, runs of blanks, newlines, name and digit
+// characters are found 16 or 32 bytes at once by SIMD compares and bit masks
+class FastScanner
+{
+public:
+	enum Simd { SCALAR, SSE2, AVX2 };
+private:
+	int m_simd;
+	const char* m_pos;
+	const char* m_end;
+	char* m_mapped; // mapped file, NULL if source is in m_buffer or given by caller
+	size_t m_mapped_size;
+	std::string m_buffer; // source read from pipe
+
+	size_t run(const char* p, int cls) const; // length of run of class cls at p
+
+	FastScanner(const FastScanner&);
+	const FastScanner& operator = (const FastScanner&);
+public:
+	FastScanner() : m_simd(best_simd()), m_pos(NULL), m_end(NULL), m_mapped(NULL), m_mapped_size(0) {}
+	~FastScanner() { end(); }
+	// best level supported by processor
+	static int best_simd();
+	static const char* simd_name(int simd);
+	int simd() const { return m_simd; }
+	// return 0 if processor doesn't support level
+	int set_simd(int simd);
+
+	// scan driver.file, "-" is stdin, errors are reported by driver
+	void begin(ParserDriver& driver);
+	// scan text, it is not copied and must live until end()
+	void begin(ParserDriver& driver, const char* text, size_t size);
+	void end();
+	yy::CalcParser::symbol_type next(ParserDriver& driver);
+};
+
+#endif // FAST_SCANNER_H
@@ -0,0 +1,241 @@
+// generator of valid calc programs for scaling tests, built by 'make gen'
+// usage: ./gen [options] > program.in
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+struct Params
+{
+	int functions; // called as tree, every function is called once
+	int statements; // simple statements in function body
+	int depth; // nesting of while and if
+	int iterations; // of every while
+	int recursion; // depth of recursive function, 0 for none
+	int array_size;
+	int init_length; // of array init list, 0 for declaration without list
+	int fanout; // calls from every function
+	unsigned int seed;
+};
+
+static const int local_vars = 4;
+
+class Generator
+{
+	const Params& m_params;
+	std::ostringstream m_out;
+	unsigned int m_random;
+
+	Generator(const Generator&);
+	const Generator& operator = (const Generator&);
+
+	// linear congruential, same seed gives same program on every platform
+	int random(int n)
+	{
+		m_random = m_random * 1103515245u + 12345u;
+		return (m_random >> 16) % n;
+	}
+	void indent(int level)
+	{
+		for (int i = 0; i < level; i++) m_out << "\t";
+	}
+	void expr(int depth);
+	void simple_statement(int level);
+	void block(int statements, int depth, int level);
+	void function(int id);
+	void recursive_function();
+public:
+	Generator(const Params& params) : m_params(params), m_random(params.seed) {}
+	std::string program();
+};
+
+void Generator::expr(int depth)
+{
+	int choice = depth > 0 ? random(7) : random(3);
+	switch (choice) {
+	case 0:
+		m_out << "x" << random(local_vars);
+		break;
+	case 1:
+		m_out << random(100) << "." << random(10);
+		break;
+	case 2:
+		m_out << "v[" << random(m_params.array_size) << "]";
+		break;
+	case 3:
+		expr(depth - 1);
+		m_out << " + ";
+		expr(depth - 1);
+		break;
+	case 4:
+		m_out << "(";
+		expr(depth - 1);
+		m_out << " - ";
+		expr(depth - 1);
+		m_out << ") * 0.5";
+		break;
+	case 5:
+		expr(depth - 1);
+		m_out << (random(2) ? " < " : " == ");
+		expr(depth - 1);
+		break;
+	default:
+		m_out << "(";
+		expr(depth - 1);
+		m_out << " ? ";
+		expr(depth - 1);
+		m_out << " : ";
+		expr(depth - 1);
+		m_out << ")";
+		break;
+	}
+}
+
+void Generator::simple_statement(int level)
+{
+	indent(level);
+	switch (random(5)) {
+	case 0:
+		m_out << "v[" << random(m_params.array_size) << "] = ";
+		expr(2);
+		break;
+	case 1:
+		m_out << "x" << random(local_vars) << "++";
+		break;
+	default:
+		m_out << "x" << random(local_vars) << " = ";
+		expr(2);
+		break;
+	}
+	m_out << ";\n";
+}
+
+// first statement opens nested while or if while depth allows
+void Generator::block(int statements, int depth, int level)
+{
+	for (int i = 0; i < statements; i++) {
+		if (depth == 0 || i != 0) {
+			simple_statement(level);
+			continue;
+		}
+		int inner = statements / 4 > 2 ? statements / 4 : 2;
+		int nesting = m_params.depth - depth + 1; // counter of this level
+		if (random(2)) {
+			indent(level);
+			m_out << "c" << nesting << " = 0;\n";
+			indent(level);
+			m_out << "while (c" << nesting << " < " << m_params.iterations << ") {\n";
+			block(inner, depth - 1, level + 1);
+			indent(level + 1);
+			m_out << "c" << nesting << "++;\n";
+			indent(level);
+			m_out << "}\n";
+		} else {
+			indent(level);
+			m_out << "if (";
+			expr(1);
+			m_out << ") {\n";
+			block(inner, depth - 1, level + 1);
+			indent(level);
+			m_out << "} else {\n";
+			block(inner, 0, level + 1); // nesting both branches would grow exponentially
+			indent(level);
+			m_out << "}\n";
+		}
+	}
+}
+
+void Generator::function(int id)
+{
+	m_out << "function f" << id << "(a, b)\n{\n";
+	m_out << "\tx0 = a;\n\tx1 = b;\n";
+	for (int i = 2; i < local_vars; i++) m_out << "\tx" << i << " = " << i << ".5;\n";
+	for (int i = 1; i <= m_params.depth; i++) m_out << "\tc" << i << " = 0;\n";
+	m_out << "\tv[" << m_params.array_size << "]";
+	if (m_params.init_length > 0) {
+		m_out << " = [";
+		for (int i = 0; i < m_params.init_length; i++) m_out << (i > 0 ? ", " : "") << random(1000) << "." << random(10);
+		m_out << "]";
+	}
+	m_out << ";\n";
+	block(m_params.statements, m_params.depth, 1);
+	m_out << "\tresult = x0 + x1";
+	for (int i = 1; i <= m_params.fanout; i++) {
+		int callee = id * m_params.fanout + i;
+		if (callee >= m_params.functions) break;
+		m_out << " + f" << callee << "(x" << random(local_vars) << ", x" << random(local_vars) << ")";
+	}
+	m_out << ";\n}\n\n";
+}
+
+void Generator::recursive_function()
+{
+	m_out << "function rec(n)\n{\n\tresult = n;\n\tif (n > 0) {\n\t\tresult = rec(n - 1) + 1.0;\n\t}\n}\n\n";
+}
+
+std::string Generator::program()
+{
+	for (int i = 0; i < m_params.functions; i++) function(i);
+	if (m_params.recursion > 0) recursive_function();
+	m_out << "function main()\n{\n\tresult = f0(1.0, 2.0)";
+	if (m_params.recursion > 0) m_out << " + rec(" << m_params.recursion << ")";
+	m_out << ";\n}\n";
+	return m_out.str();
+}
+
+static void usage()
+{
+	std::cout << "Usage: ./gen [options] > program.in\n";
+	std::cout << "options:\n";
+	std::cout << "\t-f count\tfunctions (default 10)\n";
+	std::cout << "\t-s count\tstatements in function body (default 20)\n";
+	std::cout << "\t-d depth\tnesting of while and if (default 2)\n";
+	std::cout << "\t-w count\titerations of every while (default 2)\n";
+	std::cout << "\t-r depth\tdepth of recursive calls, 0 for none (default 0)\n";
+	std::cout << "\t-a size\t\tsize of array in every function (default 8)\n";
+	std::cout << "\t-l length\tlength of array init list, 0 for none (default 8)\n";
+	std::cout << "\t-o count\tcalls from every function (default 2)\n";
+	std::cout << "\t-S seed\t\tseed of random choices (default 1)\n";
+	exit(-1);
+}
+
+int main(int argc, char** argv)
+{
+	Params params;
+	params.functions = 10;
+	params.statements = 20;
+	params.depth = 2;
+	params.iterations = 2;
+	params.recursion = 0;
+	params.array_size = 8;
+	params.init_length = 8;
+	params.fanout = 2;
+	params.seed = 1;
+	for (int i = 1; i < argc; i++) {
+		if (argv[i][0] != '-' || strlen(argv[i]) != 2 || i + 1 >= argc) usage();
+		int value = atoi(argv[++i]);
+		switch (argv[i - 1][1]) {
+		case 'f': params.functions = value; break;
+		case 's': params.statements = value; break;
+		case 'd': params.depth = value; break;
+		case 'w': params.iterations = value; break;
+		case 'r': params.recursion = value; break;
+		case 'a': params.array_size = value; break;
+		case 'l': params.init_length = value; break;
+		case 'o': params.fanout = value; break;
+		case 'S': params.seed = value; break;
+		default: usage();
+		}
+	}
+	if (params.functions < 1 || params.statements < 0 || params.depth < 0 || params.iterations < 0
+		|| params.recursion < 0 || params.array_size < 1 || params.init_length < 0 || params.fanout < 0)
+		usage();
+	if (params.init_length > params.array_size) params.array_size = params.init_length;
+
+	Generator generator(params);
+	std::cout << generator.program();
+	return 0;
+}
@@ -15,13 +15,12 @@ int HashTable::put(ParserFunc* pf)
 		Node* curr = m_hash_table[hash];
 		while (1) {
 			if (pf->name == curr->func->name) {
-				m_hash_table[hash]->func = pf;
+				curr->func = pf;
 				return 0;
 			} else {
 				if (curr->next == NULL) {
 					curr->next = new Node;
-					m_hash_table[hash]->func = pf;
-					m_hash_table[hash]->next = NULL;
+					curr->next->func = pf;
 					return 1;
 				}
 				curr = curr->next;
@@ -47,3 +46,36 @@ ParserFunc* HashTable::get(std::string name) const
 		return NULL;
 	}
 }
+
+ParserFunc* HashTable::remove(const std::string& name)
+{
+	Node** link = &m_hash_table[hash_func(name)];
+	while (*link != NULL && (*link)->func->name != name) link = &(*link)->next;
+	if (*link == NULL) return NULL;
+	Node* node = *link;
+	ParserFunc* func = node->func;
+	*link = node->next;
+	node->func = NULL;
+	node->next = NULL;
+	delete node;
+	return func;
+}
+
+void HashTable::get_all(std::vector<ParserFunc*>& funcs) const
+{
+	for (int i = 0; i < m_size; i++) {
+		for (Node* curr = m_hash_table[i]; curr != NULL; curr = curr->next) {
+			if (curr->func != NULL) funcs.push_back(curr->func);
+		}
+	}
+}
+
+void HashTable::take_all(std::vector<ParserFunc*>& funcs)
+{
+	get_all(funcs);
+	for (int i = 0; i < m_size; i++) {
+		for (Node* curr = m_hash_table[i]; curr != NULL; curr = curr->next) curr->func = NULL;
+		if (m_hash_table[i] != NULL) delete m_hash_table[i];
+		m_hash_table[i] = NULL;
+	}
+}
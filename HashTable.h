@@ -13,6 +13,7 @@ class HashTable
 	static const unsigned int hash_coeff = 756629;
 	struct Node
 	{
+		MEMORY_TAG(MEM_FUNCTIONS)
 		ParserFunc* func;
 		Node* next;
 		Node() : func(NULL), next(NULL)
@@ -52,6 +53,12 @@ public:
 	// return 0 if exist, 1 if not exist
 	int put(ParserFunc* pf);
 	ParserFunc* get(std::string name) const;
+	// remove function from table and return it, NULL if it doesn't exist
+	ParserFunc* remove(const std::string& name);
+	// append all stored functions to funcs
+	void get_all(std::vector<ParserFunc*>& funcs) const;
+	// append all stored functions to funcs and remove them, caller deletes them
+	void take_all(std::vector<ParserFunc*>& funcs);
 };
 
 #endif // HASHTABLE_H
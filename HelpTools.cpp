@@ -7,3 +7,24 @@ void calc_irrecoverable_error(std::string message, std::string file, int line)
 	std::string full_msg = "Error: '" + message + "' at file '" + file + "' line " + line_str;
 	throw std::logic_error(full_msg);
 }
+
+unsigned long long hash_bytes(const char* data, size_t size, unsigned long long hash)
+{
+	for (size_t i = 0; i < size; i++) {
+		hash ^= static_cast<unsigned char>(data[i]);
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+unsigned long long hash_file(const std::string& file)
+{
+	FILE* in = fopen(file.c_str(), "rb");
+	if (in == NULL) return 0;
+	unsigned long long hash = hash_bytes(NULL, 0);
+	char buf[4096];
+	size_t size;
+	while ((size = fread(buf, 1, sizeof(buf), in)) > 0) hash = hash_bytes(buf, size, hash);
+	fclose(in);
+	return hash;
+}
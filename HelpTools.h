@@ -9,4 +9,9 @@
 
 void calc_irrecoverable_error(std::string message, std::string file, int line);
 
+// FNV-1a of bytes, continues hash of previous bytes
+unsigned long long hash_bytes(const char* data, size_t size, unsigned long long hash = 14695981039346656037ULL);
+// FNV-1a of file contents, 0 if file can't be read
+unsigned long long hash_file(const std::string& file);
+
 #endif // HELPTOOLS_H
@@ -4,22 +4,112 @@
 
 #include "Interpreter.h"
 #include "AbstractSyntaxTree.h"
+#include "Memoization.h"
+#include "Parallel.h"
+#include "Profiler.h"
+#include "Sampler.h"
+#include "LiveMetrics.h"
 
-Interpreter::Interpreter(HashTable* functable, std::map<unsigned int, std::pair<std::string, unsigned int> >* sym_table)
+// returns control from evaluated expression to Interpreter::run()
+class ASTHaltNode : public IASTNode
+{
+public:
+	ASTHaltNode() : IASTNode(EMPTY) {}
+	~ASTHaltNode() {}
+	void run(InterpreterState& int_st, ExecutionState&) { int_st.execution_end = 1; }
+	ISSANode* make_ssa(SSAList&)
+	{
+		calc_unreachable("Not implemented");
+		return NULL;
+	}
+	void print(int) {}
+};
+
+Interpreter::Interpreter(HashTable* functable, std::map<unsigned int, std::pair<std::string, unsigned int> >* sym_table,
+	const std::string& entry)
 {
 	int_state.functable = functable;
 	int_state.sym_table = sym_table;
-	ParserFunc* pf = int_state.functable->get("main");
+	ParserFunc* pf = int_state.functable->get(entry);
 	if (pf == NULL) {
-		calc_unreachable("Function 'main()' not found");
+		calc_unreachable("Function '" + entry + "()' not found");
 	}
-	exec_state.command = new ASTFuncCallNode("main");
+	int_state.entry = entry;
+	m_entry = new ASTFuncCallNode(entry);
+	m_trace_buffer = NULL;
+	m_profiler = NULL;
+	exec_state.command = m_entry;
+	exec_state.cmd_state = 0;
+	exec_state.variables = NULL;
+	exec_state.arrays = NULL;
+	exec_state.result = 0.0;
+	int_state.trace = &std::cout;
+	int_state.calls = 0;
+	int_state.pool = NULL;
+	int_state.sampler = NULL;
+	int_state.timeline = NULL;
+	int_state.metrics = NULL;
+	int_state.pgo = NULL;
+	int_state.fork_depth = 0;
+	int_state.max_fork_depth = 0;
+	int_state.execution_end = 0;
+}
+
+Interpreter::Interpreter(const InterpreterState& parent, const ExecutionState& frame, IASTNode* expr)
+{
+	int_state.functable = parent.functable;
+	int_state.sym_table = parent.sym_table;
+	int_state.entry = parent.entry;
+	m_entry = new ASTHaltNode;
+	m_trace_buffer = NULL;
+	m_profiler = NULL;
+	exec_state = frame;
+	int_state.command_stack.push(m_entry);
+	int_state.op_stack.push(0);
+	exec_state.command = expr;
 	exec_state.cmd_state = 0;
+	int_state.trace = NULL;
+	if (parent.trace != NULL) {
+		m_trace_buffer = new std::ostringstream;
+		int_state.trace = m_trace_buffer;
+	}
+	int_state.calls = 0;
+	int_state.pool = parent.pool;
+	int_state.sampler = NULL;
+	int_state.timeline = NULL;
+	int_state.metrics = NULL;
+	int_state.pgo = NULL;
+	int_state.fork_depth = parent.fork_depth + 1;
+	int_state.max_fork_depth = parent.max_fork_depth;
 	int_state.execution_end = 0;
 }
 
 double Interpreter::run() {
 	try {
+		if (m_profiler != NULL) {
+			while (!int_state.execution_end) {
+				m_profiler->step(exec_state.command, int_state.command_stack.size());
+				exec_state.command->run(int_state, exec_state);
+			}
+			m_profiler->finish();
+		}
+		if (int_state.sampler != NULL) {
+			int_state.sampler->start(&exec_state);
+			while (!int_state.execution_end) {
+				exec_state.command->run(int_state, exec_state);
+				if (int_state.sampler->backlog()) int_state.sampler->drain();
+			}
+			int_state.sampler->stop();
+		}
+		if (int_state.metrics != NULL) {
+			unsigned long long steps = 0;
+			while (!int_state.execution_end) {
+				exec_state.command->run(int_state, exec_state);
+				if (++steps % LiveMetrics::publish_steps == 0)
+					int_state.metrics->publish(steps, int_state.calls, MemoryStats::current(MEM_ARRAYS));
+			}
+			int_state.metrics->publish(steps, int_state.calls, MemoryStats::current(MEM_ARRAYS), 1);
+		}
 		while (!int_state.execution_end) {
 			//int_state.data_stack.print();
 			exec_state.command->run(int_state, exec_state);
@@ -27,7 +117,7 @@ double Interpreter::run() {
 	}
 	catch (const std::bad_alloc&)
 	{
-		std::cerr << "Interpreter : Out of memory\n";
+		if (!MemoryStats::limit_exceeded()) std::cerr << "Interpreter : Out of memory\n";
 		throw;
 	}
 	double ret = int_state.data_stack.top();
@@ -35,6 +125,77 @@ double Interpreter::run() {
 	return ret;
 }
 
+static void flush_memo_stack(InterpreterState& int_st)
+{
+	// execution stopped inside memoized calls, don't lose their trace
+	while (!int_st.memo_stack.empty()) {
+		MemoCall* call = int_st.memo_stack.top();
+		int_st.memo_stack.pop();
+		if (call->trace != NULL) {
+			*call->parent_trace << call->trace->str();
+			int_st.trace = call->parent_trace;
+		}
+		delete call;
+	}
+}
+
 Interpreter::~Interpreter() {
-	delete exec_state.command;
+	flush_memo_stack(int_state);
+	// variables of calls interrupted by error, frame below first call isn't owned
+	if (!int_state.execution_end && !int_state.var_stack.empty()) {
+		delete exec_state.variables;
+		while (int_state.var_stack.size() > 1) {
+			delete int_state.var_stack.top();
+			int_state.var_stack.pop();
+		}
+	}
+	delete m_entry;
+	if (m_trace_buffer != NULL) delete m_trace_buffer;
+}
+
+std::string Interpreter::get_trace()
+{
+	if (m_trace_buffer == NULL) return "";
+	flush_memo_stack(int_state);
+	return m_trace_buffer->str();
+}
+
+void Interpreter::enable_parallel(ThreadPool* pool, int max_fork_depth)
+{
+	mark_fork_points(*int_state.functable);
+	MemoryStats::set_shared();
+	int_state.pool = pool;
+	int_state.max_fork_depth = max_fork_depth;
+}
+
+void Interpreter::enable_memo(unsigned int capacity)
+{
+	mark_pure_functions(*int_state.functable);
+	std::vector<ParserFunc*> funcs;
+	int_state.functable->get_all(funcs);
+	for (unsigned int i = 0; i < funcs.size(); i++) {
+		if (funcs[i]->name == int_state.entry) continue; // called once
+		if (funcs[i]->pure && funcs[i]->memo == NULL) funcs[i]->memo = new MemoCache(capacity);
+	}
+}
+
+void Interpreter::print_memo_stats(std::ostream& out) const
+{
+	std::vector<ParserFunc*> funcs;
+	int_state.functable->get_all(funcs);
+	for (unsigned int i = 0; i < funcs.size(); i++) {
+		MemoCache* memo = funcs[i]->memo;
+		if (memo == NULL) continue;
+		out << "memo '" << funcs[i]->name << "': hits " << memo->hits << ", misses " << memo->misses
+			<< ", evictions " << memo->evictions << ", uncached " << memo->uncached
+			<< ", size " << memo->size() << "/" << memo->capacity() << std::endl;
+	}
+}
+
+void Interpreter::print_array_stats(std::ostream& out) const
+{
+	out << "arrays: copies " << ArrayHandle::copies << ", bytes copied " << ArrayHandle::copied_bytes
+		<< ", arena bytes " << int_state.arena.reserved() << std::endl;
+	out << "arrays: declared bytes " << ArrayHandle::declared_bytes
+		<< ", materialized bytes " << ArrayHandle::materialized_bytes << std::endl;
 }
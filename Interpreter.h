@@ -5,18 +5,34 @@
 #include "BinarySearchTree.h"
 #include "ParserFunc.h"
 #include "Stack.h"
+#include "Array.h"
+#include "MemoryStats.h"
 
 #include <map>
 #include <string>
 #include <vector>
+#include <ostream>
+#include <sstream>
+
+struct MemoCall;
+class ThreadPool;
+class Profiler;
+class Sampler;
+class Timeline;
+class LiveMetrics;
+class PGOProfile;
+
+// variables of function frame
+typedef std::map<unsigned int, double, std::less<unsigned int>,
+	TrackedAllocator<std::pair<const unsigned int, double>, MEM_FRAMES> > VariableMap;
 
 struct ExecutionState
 {
 	IASTNode* command;
 	unsigned int cmd_state;
-	std::map<unsigned int, double>* variables;
-	std::map<unsigned int, std::vector<double> >* arrays;
-	double result; // result of last function call, existence of result assignment checked by parser
+	VariableMap* variables;
+	ArrayHandle* arrays; // frame slots
+	double result; // of current call, 0 until assigned; existence of result assignment checked by parser
 };
 
 struct InterpreterState
@@ -24,11 +40,24 @@ struct InterpreterState
 	HashTable* functable;
 	std::map<unsigned int, std::pair<std::string, unsigned int> >* sym_table;
 
-	Stack<std::map<unsigned int, double>*> var_stack;
-	Stack<std::map<unsigned int, std::vector<double> >*> arr_stack;
+	Stack<VariableMap*> var_stack;
+	Stack<ArrayHandle*> arr_stack;
+	Stack<Arena::Mark> arena_stack; // arena state before each call
+	Arena arena; // arrays of all frames
 	Stack<int> op_stack;
 	Stack<double> data_stack;
 	Stack<IASTNode*> command_stack;
+	Stack<MemoCall*> memo_stack; // calls of memoized functions in progress
+	std::ostream* trace; // assignments are printed here, NULL disables tracing
+	unsigned long long calls; // number of executed function calls
+	ThreadPool* pool; // NULL if parallel evaluation is disabled
+	Sampler* sampler; // keeps shadow call stack, NULL if sampling is disabled
+	Timeline* timeline; // receives calls and loop iterations, NULL if disabled
+	LiveMetrics* metrics; // keeps call stack for published metrics, NULL if disabled
+	PGOProfile* pgo; // records branches, loops and calls for compiler, NULL if disabled
+	std::string entry; // function whose return ends execution
+	int fork_depth; // number of parallel evaluations this interpreter is nested in
+	int max_fork_depth; // deeper operands are evaluated sequentially
 	int execution_end;
 };
 
@@ -36,12 +65,40 @@ class Interpreter
 {
 	ExecutionState exec_state;
 	InterpreterState int_state;
+	IASTNode* m_entry; // call of main() or end of evaluated expression
+	std::ostringstream* m_trace_buffer; // trace of evaluated expression
+	Profiler* m_profiler; // NULL if profiling is disabled
 	Interpreter(const Interpreter&);
 	const Interpreter& operator=(const Interpreter&);
 public:
-	Interpreter(HashTable* functable, std::map<unsigned int, std::pair<std::string, unsigned int> >* sym_table);
+	// run function entry without arguments
+	Interpreter(HashTable* functable, std::map<unsigned int, std::pair<std::string, unsigned int> >* sym_table,
+		const std::string& entry = "main");
+	// evaluate expression in function frame of parent, frame must not be changed by expression
+	Interpreter(const InterpreterState& parent, const ExecutionState& frame, IASTNode* expr);
 	~Interpreter();
 	double run();
+	void set_trace(std::ostream* trace) { int_state.trace = trace; }
+	// report every step to profiler, forked operands are counted in their binary operation
+	void set_profiler(Profiler* profiler) { m_profiler = profiler; }
+	// sample call stack while running, calls in forked operands are not seen
+	void set_sampler(Sampler* sampler) { int_state.sampler = sampler; }
+	// write calls and loop iterations to timeline, calls in forked operands are not seen
+	void set_timeline(Timeline* timeline) { int_state.timeline = timeline; }
+	// publish progress to shared memory while running, calls in forked operands are not seen
+	void set_metrics(LiveMetrics* metrics) { int_state.metrics = metrics; }
+	// record profile for compiler, forked operands are not recorded
+	void set_pgo(PGOProfile* pgo) { int_state.pgo = pgo; }
+	// evaluate operands of pure binary operations in parallel
+	void enable_parallel(ThreadPool* pool, int max_fork_depth);
+	const ExecutionState& get_exec_state() const { return exec_state; }
+	const InterpreterState& get_int_state() const { return int_state; }
+	// trace of expression evaluation, including calls interrupted by error
+	std::string get_trace();
+	// cache results of pure functions, capacity is number of entries per function
+	void enable_memo(unsigned int capacity);
+	void print_memo_stats(std::ostream& out) const;
+	void print_array_stats(std::ostream& out) const;
 };
 
 #endif
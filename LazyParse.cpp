@@ -0,0 +1,144 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <set>
+
+#include "LazyParse.h"
+#include "ParserDriver.h"
+#include "ParserFunc.h"
+
+static int is_blank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n';
+}
+
+static int is_name_char(char c)
+{
+	return isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// name of function defined by text, empty if text doesn't start as definition
+static std::string function_name(const char* text, size_t size)
+{
+	static const char* const keywords[] = { "function", "while", "if", "else" };
+	size_t i = 0;
+	while (i < size && is_blank(text[i])) i++;
+	if (size - i < 8 || memcmp(text + i, "function", 8) != 0) return "";
+	i += 8;
+	size_t begin = i;
+	while (i < size && is_blank(text[i])) i++;
+	if (i == begin || i == size || isdigit(static_cast<unsigned char>(text[i]))) return "";
+	begin = i;
+	while (i < size && is_name_char(text[i])) i++;
+	std::string name(text + begin, i - begin);
+	while (i < size && is_blank(text[i])) i++;
+	if (name.empty() || i == size || text[i] != '(') return "";
+	for (unsigned int k = 0; k < sizeof(keywords) / sizeof(keywords[0]); k++) {
+		if (name == keywords[k]) return "";
+	}
+	return name;
+}
+
+static int blank(const char* text, size_t size)
+{
+	for (size_t i = 0; i < size; i++) {
+		if (!is_blank(text[i])) return 0;
+	}
+	return 1;
+}
+
+int LazyProgram::read(const std::string& file)
+{
+	int fd = file == "-" ? STDIN_FILENO : open(file.c_str(), O_RDONLY);
+	if (fd < 0) return 0;
+	struct stat st;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+		void* addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (addr != MAP_FAILED) {
+			m_mapped = static_cast<char*>(addr);
+			m_mapped_size = st.st_size;
+		}
+	}
+	ssize_t size = 0;
+	if (m_mapped == NULL) {
+		char block[1 << 16];
+		while ((size = ::read(fd, block, sizeof(block))) != 0) {
+			if (size > 0) m_buffer.append(block, size);
+			else if (errno != EINTR) break;
+		}
+	}
+	if (fd != STDIN_FILENO) close(fd);
+	m_text = m_mapped != NULL ? m_mapped : m_buffer.data();
+	m_size = m_mapped != NULL ? m_mapped_size : m_buffer.size();
+	return size >= 0;
+}
+
+void LazyProgram::release()
+{
+	if (m_mapped != NULL) munmap(m_mapped, m_mapped_size);
+	m_mapped = NULL;
+	m_buffer.clear();
+	m_text = NULL;
+	m_size = 0;
+	m_chunks.clear();
+}
+
+int LazyProgram::parse(const std::string& file)
+{
+	release();
+	m_driver.file = file;
+	if (!read(file)) m_driver.error("Cannot open " + file);
+
+	std::vector<SourceChunk> chunks;
+	split_functions(m_text, m_size, chunks);
+	std::vector<std::string> names;
+	std::set<std::string> defined;
+	for (unsigned int i = 0; i < chunks.size(); i++) {
+		const char* text = m_text + chunks[i].begin;
+		size_t size = chunks[i].end - chunks[i].begin;
+		std::string name = function_name(text, size);
+		if (name.empty() && blank(text, size)) continue;
+		// parser reports errors
+		if (name.empty() || !defined.insert(name).second) return m_driver.parse(file, m_text, m_size, yy::position());
+		names.push_back(name);
+		m_chunks.push_back(chunks[i]);
+	}
+	if (names.empty()) return m_driver.parse(file, m_text, m_size, yy::position());
+
+	for (unsigned int i = 0; i < names.size(); i++) {
+		ParserFunc* f = new ParserFunc;
+		f->name = names[i];
+		f->lazy = this;
+		f->lazy_index = i;
+		m_driver.functable.put(f);
+	}
+	return 0;
+}
+
+void LazyProgram::load(ParserFunc* f)
+{
+	const SourceChunk& chunk = m_chunks[f->lazy_index];
+	ParserDriver part;
+	part.fast_scanning = m_driver.fast_scanning;
+	part.fast_scanner.set_simd(m_driver.fast_scanner.simd());
+	part.last_index = m_driver.last_index; // ids follow symbols of functions loaded before
+	if (part.parse(m_driver.file, m_text + chunk.begin, chunk.end - chunk.begin, chunk.start))
+		calc_unreachable("Parser error");
+	std::vector<ParserFunc*> funcs;
+	part.functable.take_all(funcs);
+	if (funcs.size() != 1 || funcs[0]->name != f->name) calc_unreachable("Function source range is wrong");
+
+	ParserFunc* parsed = funcs[0];
+	f->arg.swap(parsed->arg);
+	f->body = parsed->body;
+	parsed->body = NULL;
+	f->array_lengths.swap(parsed->array_lengths);
+	f->lazy = NULL;
+	delete parsed;
+	m_driver.sym_table.insert(part.sym_table.begin(), part.sym_table.end());
+	m_driver.last_index = part.last_index;
+}
@@ -0,0 +1,41 @@
+#ifndef LAZY_PARSE_H
+#define LAZY_PARSE_H
+
+#include <string>
+#include <vector>
+
+#include "ParallelParse.h"
+
+class ParserDriver;
+struct ParserFunc;
+
+// functions of program are parsed on first call: parse() finds name and source range
+// of every function without parser, load() parses one function when it is called;
+// source stays mapped while functions can be loaded
+class LazyProgram
+{
+	ParserDriver& m_driver;
+	char* m_mapped; // NULL if source is in m_buffer
+	size_t m_mapped_size;
+	std::string m_buffer; // source read from pipe
+	const char* m_text;
+	size_t m_size;
+	std::vector<SourceChunk> m_chunks; // by ParserFunc::lazy_index
+
+	// return 0 if source can't be read
+	int read(const std::string& file);
+	void release();
+
+	LazyProgram(const LazyProgram&);
+	const LazyProgram& operator = (const LazyProgram&);
+public:
+	LazyProgram(ParserDriver& driver) : m_driver(driver), m_mapped(NULL), m_mapped_size(0), m_text(NULL), m_size(0) {}
+	~LazyProgram() { release(); }
+	// put unparsed functions of file into empty driver, whole file is parsed if its
+	// functions can't be found without parser; return 0 on success as driver.parse()
+	int parse(const std::string& file);
+	// parse f on its first call, errors are thrown as by parser
+	void load(ParserFunc* f);
+};
+
+#endif // LAZY_PARSE_H
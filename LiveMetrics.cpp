@@ -0,0 +1,133 @@
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include "LiveMetrics.h"
+
+LiveMetrics::LiveMetrics() : m_block(NULL), m_last_steps(0), m_last_ns(0), m_finished(0) {}
+
+LiveMetrics::~LiveMetrics()
+{
+	close();
+}
+
+void LiveMetrics::close()
+{
+	if (m_block == NULL) return;
+	munmap(m_block, sizeof(Block));
+	m_block = NULL;
+	if (!m_finished) remove(m_name); // run ended by error
+}
+
+void LiveMetrics::remove(const std::string& name)
+{
+	shm_unlink(name.c_str());
+}
+
+unsigned long long LiveMetrics::now_ns()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+std::string LiveMetrics::segment_name(unsigned long long pid)
+{
+	char buf[32];
+	sprintf(buf, "/calc.%llu", pid);
+	return buf;
+}
+
+int LiveMetrics::open()
+{
+	m_name = segment_name(getpid());
+	int fd = shm_open(m_name.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+	if (fd < 0) return 0;
+	if (ftruncate(fd, sizeof(Block)) != 0) {
+		::close(fd);
+		shm_unlink(m_name.c_str());
+		return 0;
+	}
+	void* addr = mmap(NULL, sizeof(Block), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (addr == MAP_FAILED) {
+		shm_unlink(m_name.c_str());
+		return 0;
+	}
+	m_block = static_cast<Block*>(addr); // zero filled by ftruncate
+	m_last_ns = now_ns();
+	m_block->pid = getpid();
+	m_block->start_ns = m_last_ns;
+	__atomic_store_n(&m_block->magic, magic, __ATOMIC_RELEASE);
+	return 1;
+}
+
+void LiveMetrics::publish(unsigned long long steps, unsigned long long calls, unsigned long long array_bytes, int finished)
+{
+	if (m_block == NULL) return;
+	unsigned long long now = now_ns();
+	unsigned long long rate = now > m_last_ns ? (steps - m_last_steps) * 1000000000ULL / (now - m_last_ns) : 0;
+	m_last_steps = steps;
+	m_last_ns = now;
+
+	unsigned int sequence = m_block->sequence;
+	__atomic_store_n(&m_block->sequence, sequence + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE); // odd sequence is visible before fields
+	store(&m_block->update_ns, now);
+	store(&m_block->steps, steps);
+	store(&m_block->calls, calls);
+	store(&m_block->depth, m_frames.size());
+	store(&m_block->array_bytes, array_bytes);
+	store(&m_block->steps_per_second, rate);
+	store(&m_block->finished, finished);
+	m_finished = finished;
+	const char* function = m_frames.empty() ? "" : m_frames.back()->name.c_str();
+	for (unsigned int i = 0; i < name_size; i++) {
+		__atomic_store_n(&m_block->function[i], i + 1 < name_size ? function[i] : '\0', __ATOMIC_RELAXED);
+		if (function[i] == '\0') break;
+	}
+	__atomic_store_n(&m_block->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+int LiveMetrics::read(const std::string& name, Block& snapshot)
+{
+	int fd = shm_open(name.c_str(), O_RDONLY, 0);
+	if (fd < 0) return 0;
+	void* addr = mmap(NULL, sizeof(Block), PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (addr == MAP_FAILED) return 0;
+	Block* block = static_cast<Block*>(addr);
+	int res = 0;
+	while (__atomic_load_n(&block->magic, __ATOMIC_ACQUIRE) == magic) {
+		unsigned int before = __atomic_load_n(&block->sequence, __ATOMIC_ACQUIRE);
+		if (before & 1) { // writer is inside update
+			sched_yield();
+			continue;
+		}
+		snapshot.magic = magic;
+		snapshot.sequence = before;
+		snapshot.pid = __atomic_load_n(&block->pid, __ATOMIC_RELAXED);
+		snapshot.start_ns = __atomic_load_n(&block->start_ns, __ATOMIC_RELAXED);
+		snapshot.update_ns = __atomic_load_n(&block->update_ns, __ATOMIC_RELAXED);
+		snapshot.steps = __atomic_load_n(&block->steps, __ATOMIC_RELAXED);
+		snapshot.calls = __atomic_load_n(&block->calls, __ATOMIC_RELAXED);
+		snapshot.depth = __atomic_load_n(&block->depth, __ATOMIC_RELAXED);
+		snapshot.array_bytes = __atomic_load_n(&block->array_bytes, __ATOMIC_RELAXED);
+		snapshot.steps_per_second = __atomic_load_n(&block->steps_per_second, __ATOMIC_RELAXED);
+		snapshot.finished = __atomic_load_n(&block->finished, __ATOMIC_RELAXED);
+		for (unsigned int i = 0; i < name_size; i++) snapshot.function[i] = __atomic_load_n(&block->function[i], __ATOMIC_RELAXED);
+		snapshot.function[name_size - 1] = '\0';
+		__atomic_thread_fence(__ATOMIC_ACQUIRE); // fields are read before sequence is checked again
+		if (__atomic_load_n(&block->sequence, __ATOMIC_RELAXED) == before) {
+			res = 1;
+			break;
+		}
+	}
+	munmap(addr, sizeof(Block));
+	return res;
+}
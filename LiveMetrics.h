@@ -0,0 +1,67 @@
+#ifndef LIVE_METRICS_H
+#define LIVE_METRICS_H
+
+#include <string>
+#include <vector>
+
+#include "ParserFunc.h"
+
+// counters of running interpreter in POSIX shared memory segment "/calc.<pid>",
+// read by calc-top; writer publishes snapshot every few thousand steps,
+// readers retry while sequence number is odd or changed (seqlock); segment of
+// finished run is kept for calc-top, which removes it after showing it
+class LiveMetrics
+{
+public:
+	static const unsigned int magic = 0x63616c63; // "calc"
+	static const unsigned int name_size = 64;
+	static const unsigned int publish_steps = 1 << 16; // steps between snapshots
+
+	struct Block
+	{
+		unsigned int magic;
+		unsigned int sequence; // odd while writer updates block
+		unsigned long long pid;
+		unsigned long long start_ns; // CLOCK_MONOTONIC
+		unsigned long long update_ns;
+		unsigned long long steps;
+		unsigned long long calls;
+		unsigned long long depth; // of calls, main is 1
+		unsigned long long array_bytes; // peak, arena chunks are reused but not freed
+		unsigned long long steps_per_second; // since previous snapshot
+		unsigned long long finished;
+		char function[name_size]; // innermost function
+	};
+private:
+	std::string m_name;
+	Block* m_block;
+	std::vector<const ParserFunc*> m_frames; // call stack of interpreter
+	unsigned long long m_last_steps;
+	unsigned long long m_last_ns;
+	int m_finished; // final snapshot is published
+
+	void store(unsigned long long* field, unsigned long long value) { __atomic_store_n(field, value, __ATOMIC_RELAXED); }
+
+	LiveMetrics(const LiveMetrics&);
+	const LiveMetrics& operator = (const LiveMetrics&);
+public:
+	LiveMetrics();
+	~LiveMetrics();
+	// return 0 if segment can't be created
+	int open();
+	// unmap segment, remove it unless final snapshot was published
+	void close();
+	void call(const ParserFunc* func) { m_frames.push_back(func); }
+	void ret() { if (!m_frames.empty()) m_frames.pop_back(); }
+	void publish(unsigned long long steps, unsigned long long calls, unsigned long long array_bytes, int finished = 0);
+	const std::string& name() const { return m_name; }
+
+	static unsigned long long now_ns();
+	static std::string segment_name(unsigned long long pid);
+	// consistent copy of block of running process, return 0 if segment doesn't exist
+	static int read(const std::string& name, Block& snapshot);
+	// remove segment of finished or dead process
+	static void remove(const std::string& name);
+};
+
+#endif // LIVE_METRICS_H
@@ -0,0 +1,126 @@
+#include <cstring>
+
+#include "Memoization.h"
+#include "AbstractSyntaxTree.h"
+#include "ParserFunc.h"
+
+std::string MemoCache::make_key(const std::vector<double>& args)
+{
+	// compare bit patterns, so -0.0 and 0.0 are different keys
+	std::string key(args.size() * sizeof(double), '\0');
+	if (!args.empty()) memcpy(&key[0], &args[0], key.size());
+	return key;
+}
+
+MemoCache::MemoCache(unsigned int capacity) : m_capacity(capacity), hits(0), misses(0), evictions(0), uncached(0)
+{
+	pthread_mutex_init(&m_lock, NULL);
+}
+
+MemoCache::~MemoCache()
+{
+	pthread_mutex_destroy(&m_lock);
+}
+
+unsigned int MemoCache::size() const
+{
+	pthread_mutex_lock(&m_lock);
+	unsigned int size = m_index.size();
+	pthread_mutex_unlock(&m_lock);
+	return size;
+}
+
+int MemoCache::lookup(const std::string& key, double& result, std::string& trace)
+{
+	pthread_mutex_lock(&m_lock);
+	std::map<std::string, std::list<Entry>::iterator>::iterator it = m_index.find(key);
+	if (it == m_index.end()) {
+		misses++;
+		pthread_mutex_unlock(&m_lock);
+		return 0;
+	}
+	hits++;
+	m_entries.splice(m_entries.begin(), m_entries, it->second);
+	result = it->second->result;
+	trace = it->second->trace;
+	pthread_mutex_unlock(&m_lock);
+	return 1;
+}
+
+void MemoCache::insert(const std::string& key, double result, const std::string& trace)
+{
+	if (m_capacity == 0) return;
+	pthread_mutex_lock(&m_lock);
+	if (trace.size() > max_trace_size) {
+		uncached++;
+		pthread_mutex_unlock(&m_lock);
+		return;
+	}
+	std::map<std::string, std::list<Entry>::iterator>::iterator it = m_index.find(key);
+	if (it != m_index.end()) { // computed by other thread meanwhile
+		m_entries.splice(m_entries.begin(), m_entries, it->second);
+		pthread_mutex_unlock(&m_lock);
+		return;
+	}
+	if (m_index.size() >= m_capacity) {
+		m_index.erase(m_entries.back().key);
+		m_entries.pop_back();
+		evictions++;
+	}
+	Entry entry;
+	entry.key = key;
+	entry.result = result;
+	entry.trace = trace;
+	m_entries.push_front(entry);
+	m_index[key] = m_entries.begin();
+	pthread_mutex_unlock(&m_lock);
+}
+
+MemoCall::~MemoCall()
+{
+	if (trace != NULL) delete trace;
+}
+
+void collect_calls(IASTNode* node, std::vector<std::string>& calls)
+{
+	if (node == NULL) return;
+	if (node->get_op() == FUNC_CALL) calls.push_back(dynamic_cast<ASTFuncCallNode*>(node)->get_name());
+	for (int i = 0; i < node->child_count(); i++) {
+		collect_calls(node->get_child(i), calls);
+	}
+}
+
+void mark_pure_functions(HashTable& functable)
+{
+	std::vector<ParserFunc*> funcs;
+	functable.get_all(funcs);
+
+	std::map<ParserFunc*, std::vector<std::string> > calls;
+	for (unsigned int i = 0; i < funcs.size(); i++) {
+		ParserFunc* f = funcs[i];
+		f->pure = 1;
+		for (unsigned int j = 0; j < f->arg.size(); j++) {
+			if (f->arg[j]->get_op() != VARIABLE) f->pure = 0;
+		}
+		collect_calls(f->body, calls[f]);
+	}
+
+	// recursive functions are assumed pure, drop purity until nothing changes
+	int changed = 1;
+	while (changed) {
+		changed = 0;
+		for (unsigned int i = 0; i < funcs.size(); i++) {
+			ParserFunc* f = funcs[i];
+			if (!f->pure) continue;
+			std::vector<std::string>& f_calls = calls[f];
+			for (unsigned int j = 0; j < f_calls.size(); j++) {
+				ParserFunc* callee = functable.get(f_calls[j]);
+				if (callee == NULL || !callee->pure) {
+					f->pure = 0;
+					changed = 1;
+					break;
+				}
+			}
+		}
+	}
+}
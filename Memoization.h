@@ -0,0 +1,67 @@
+#ifndef MEMOIZATION_H
+#define MEMOIZATION_H
+
+#include <pthread.h>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <sstream>
+
+#include "HashTable.h"
+
+// result cache of one pure function, keyed by argument tuple, LRU eviction
+// safe to share between threads of parallel evaluation
+class MemoCache
+{
+public:
+	struct Entry
+	{
+		std::string key;
+		double result;
+		std::string trace; // assignments printed by the call, replayed on hit
+	};
+	static const unsigned int max_trace_size = 64 * 1024; // longer traces are not cached
+private:
+	unsigned int m_capacity;
+	std::list<Entry> m_entries; // most recently used first
+	std::map<std::string, std::list<Entry>::iterator> m_index;
+	mutable pthread_mutex_t m_lock;
+
+	MemoCache(const MemoCache&);
+	const MemoCache& operator = (const MemoCache&);
+public:
+	unsigned long long hits;
+	unsigned long long misses;
+	unsigned long long evictions;
+	unsigned long long uncached; // results not stored because of trace size
+
+	MemoCache(unsigned int capacity);
+	~MemoCache();
+	static std::string make_key(const std::vector<double>& args);
+	// return 0 on miss
+	int lookup(const std::string& key, double& result, std::string& trace);
+	void insert(const std::string& key, double result, const std::string& trace);
+	unsigned int size() const;
+	unsigned int capacity() const { return m_capacity; }
+};
+
+// pending call of memoized function, lives until function return
+struct MemoCall
+{
+	std::string key;
+	std::ostream* parent_trace; // trace stream of caller, NULL if tracing is off
+	std::ostringstream* trace;  // buffer collecting trace of this call
+	MemoCall() : parent_trace(NULL), trace(NULL) {}
+	~MemoCall();
+};
+
+// append names of functions called in node and its children
+void collect_calls(IASTNode* node, std::vector<std::string>& calls);
+
+// set ParserFunc::pure for all functions in table
+// function is pure if it has no array arguments and calls only pure functions
+void mark_pure_functions(HashTable& functable);
+
+#endif // MEMOIZATION_H
@@ -0,0 +1,154 @@
+#include <signal.h>
+#include <unistd.h>
+
+#include "MemoryStats.h"
+
+MemoryStats::Counters MemoryStats::m_tags[MEM_TAGS];
+size_t MemoryStats::m_current = 0;
+size_t MemoryStats::m_peak = 0;
+size_t MemoryStats::m_limit = 0;
+int MemoryStats::m_limit_exceeded = 0;
+int MemoryStats::m_enabled = 0;
+int MemoryStats::m_shared = 0;
+
+static const char* tag_names[MEM_TAGS] = {
+	"ast", "ssa", "stacks", "frames", "arrays", "functions"
+};
+
+void MemoryStats::update_peak(size_t* peak, size_t value)
+{
+	size_t old = __atomic_load_n(peak, __ATOMIC_RELAXED);
+	while (value > old && !__atomic_compare_exchange_n(peak, &old, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+}
+
+void* MemoryStats::allocate(size_t size, int tag)
+{
+	if (!m_enabled) return ::operator new(size);
+	if (m_shared) return allocate_shared(size, tag);
+	if (m_limit != 0 && m_current + size > m_limit) {
+		m_limit_exceeded = 1;
+		throw std::bad_alloc();
+	}
+	void* ptr = ::operator new(size);
+	Counters& counters = m_tags[tag];
+	counters.current += size;
+	if (counters.current > counters.peak) counters.peak = counters.current;
+	counters.allocations++;
+	m_current += size;
+	if (m_current > m_peak) m_peak = m_current;
+	return ptr;
+}
+
+void* MemoryStats::allocate_shared(size_t size, int tag)
+{
+	size_t current = __atomic_add_fetch(&m_current, size, __ATOMIC_RELAXED);
+	if (m_limit != 0 && current > m_limit) {
+		__atomic_sub_fetch(&m_current, size, __ATOMIC_RELAXED);
+		m_limit_exceeded = 1;
+		throw std::bad_alloc();
+	}
+	void* ptr;
+	try {
+		ptr = ::operator new(size);
+	}
+	catch (const std::bad_alloc&) {
+		__atomic_sub_fetch(&m_current, size, __ATOMIC_RELAXED);
+		throw;
+	}
+	Counters& counters = m_tags[tag];
+	update_peak(&counters.peak, __atomic_add_fetch(&counters.current, size, __ATOMIC_RELAXED));
+	__atomic_add_fetch(&counters.allocations, 1, __ATOMIC_RELAXED);
+	update_peak(&m_peak, current);
+	return ptr;
+}
+
+void MemoryStats::release(void* ptr, size_t size, int tag)
+{
+	if (ptr == NULL) return;
+	::operator delete(ptr);
+	if (!m_enabled) return;
+	if (m_shared) {
+		release_shared(size, tag);
+		return;
+	}
+	m_tags[tag].current -= size;
+	m_current -= size;
+}
+
+void MemoryStats::release_shared(size_t size, int tag)
+{
+	__atomic_sub_fetch(&m_tags[tag].current, size, __ATOMIC_RELAXED);
+	__atomic_sub_fetch(&m_current, size, __ATOMIC_RELAXED);
+}
+
+// report is formatted without library calls, so it can be printed from signal handler
+
+static size_t append(char* buf, size_t pos, size_t size, const char* str)
+{
+	while (*str != '\0' && pos + 1 < size) buf[pos++] = *str++;
+	return pos;
+}
+
+static size_t append_number(char* buf, size_t pos, size_t size, unsigned long long value, int width)
+{
+	char digits[24];
+	int len = 0;
+	do {
+		digits[len++] = '0' + value % 10;
+		value /= 10;
+	} while (value != 0);
+	for (int i = len; i < width && pos + 1 < size; i++) buf[pos++] = ' ';
+	while (len > 0 && pos + 1 < size) buf[pos++] = digits[--len];
+	return pos;
+}
+
+size_t MemoryStats::format(char* buf, size_t size)
+{
+	size_t pos = 0;
+	pos = append(buf, pos, size, "memory: current ");
+	pos = append_number(buf, pos, size, __atomic_load_n(&m_current, __ATOMIC_RELAXED), 0);
+	pos = append(buf, pos, size, ", peak ");
+	pos = append_number(buf, pos, size, __atomic_load_n(&m_peak, __ATOMIC_RELAXED), 0);
+	if (m_limit != 0) {
+		pos = append(buf, pos, size, ", limit ");
+		pos = append_number(buf, pos, size, m_limit, 0);
+	}
+	pos = append(buf, pos, size, "\n");
+	pos = append(buf, pos, size, "         tag      current         peak  allocations\n");
+	for (int i = 0; i < MEM_TAGS; i++) {
+		pos = append(buf, pos, size, "    ");
+		size_t name_len = 0;
+		while (tag_names[i][name_len] != '\0') name_len++;
+		for (size_t j = name_len; j < 8; j++) pos = append(buf, pos, size, " ");
+		pos = append(buf, pos, size, tag_names[i]);
+		pos = append_number(buf, pos, size, __atomic_load_n(&m_tags[i].current, __ATOMIC_RELAXED), 13);
+		pos = append_number(buf, pos, size, __atomic_load_n(&m_tags[i].peak, __ATOMIC_RELAXED), 13);
+		pos = append_number(buf, pos, size, __atomic_load_n(&m_tags[i].allocations, __ATOMIC_RELAXED), 13);
+		pos = append(buf, pos, size, "\n");
+	}
+	buf[pos] = '\0';
+	return pos;
+}
+
+void MemoryStats::print(std::ostream& out)
+{
+	char buf[1024];
+	format(buf, sizeof(buf));
+	out << buf;
+}
+
+void MemoryStats::on_signal(int)
+{
+	char buf[1024];
+	size_t len = format(buf, sizeof(buf));
+	if (write(STDERR_FILENO, buf, len) < 0) return;
+}
+
+void MemoryStats::enable_signal_report()
+{
+	struct sigaction action;
+	action.sa_handler = on_signal;
+	sigemptyset(&action.sa_mask);
+	action.sa_flags = SA_RESTART;
+	sigaction(SIGUSR1, &action, NULL);
+}
@@ -0,0 +1,73 @@
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <ostream>
+
+enum MemoryTag {
+		MEM_AST, MEM_SSA, MEM_STACKS, MEM_FRAMES, MEM_ARRAYS, MEM_FUNCTIONS,
+		MEM_TAGS
+	};
+
+// allocation accounting by subsystem, disabled until enable(), then allocations only
+// call operator new; counters are updated atomically only after set_shared(),
+// atomic operations double cost of small allocations
+class MemoryStats
+{
+	struct Counters
+	{
+		size_t current;
+		size_t peak;
+		unsigned long long allocations;
+	};
+	static Counters m_tags[MEM_TAGS];
+	static size_t m_current;
+	static size_t m_peak;
+	static size_t m_limit; // 0 is no limit
+	static int m_limit_exceeded;
+	static int m_enabled;
+	static int m_shared; // allocations from several threads
+
+	static void update_peak(size_t* peak, size_t value);
+	static void* allocate_shared(size_t size, int tag);
+	static void release_shared(size_t size, int tag);
+	static size_t format(char* buf, size_t size);
+	static void on_signal(int);
+public:
+	// throw std::bad_alloc if allocation exceeds limit
+	static void* allocate(size_t size, int tag);
+	static void release(void* ptr, size_t size, int tag);
+	// call before first tracked allocation, memory allocated before isn't accounted
+	static void enable() { m_enabled = 1; }
+	static int enabled() { return m_enabled; }
+	static void set_limit(size_t limit) { m_limit = limit; }
+	static void set_shared() { m_shared = 1; }
+	static int limit_exceeded() { return m_limit_exceeded; }
+	static size_t current(int tag) { return __atomic_load_n(&m_tags[tag].current, __ATOMIC_RELAXED); }
+	// current, peak and number of allocations of every tag
+	static void print(std::ostream& out);
+	// print report to stderr on SIGUSR1
+	static void enable_signal_report();
+};
+
+// operator new and delete of class, allocations are accounted with tag
+#define MEMORY_TAG(tag) \
+	static void* operator new(size_t size) { return MemoryStats::allocate(size, tag); } \
+	static void operator delete(void* ptr, size_t size) { MemoryStats::release(ptr, size, tag); }
+
+// allocator for standard containers, allocations are accounted with tag
+template <typename T, int Tag>
+class TrackedAllocator : public std::allocator<T>
+{
+public:
+	template <typename U> struct rebind { typedef TrackedAllocator<U, Tag> other; };
+	TrackedAllocator() {}
+	TrackedAllocator(const TrackedAllocator&) : std::allocator<T>() {}
+	template <typename U> TrackedAllocator(const TrackedAllocator<U, Tag>&) {}
+	T* allocate(size_t n, const void* = 0) { return static_cast<T*>(MemoryStats::allocate(n * sizeof(T), Tag)); }
+	void deallocate(T* ptr, size_t n) { MemoryStats::release(ptr, n * sizeof(T), Tag); }
+};
+
+#endif // MEMORY_STATS_H
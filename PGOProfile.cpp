@@ -0,0 +1,105 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "PGOProfile.h"
+#include "AbstractSyntaxTree.h"
+#include "HelpTools.h"
+
+static const char* header = "# calc profile 1";
+
+static int located(const yy::location& location)
+{
+	// nodes made by parser itself have empty location
+	return location.begin.line != location.end.line || location.begin.column != location.end.column;
+}
+
+int PGOProfile::write(const std::string& file, const std::string& source) const
+{
+	// sorted by position, nodes of one position and kind are merged
+	std::map<Position, Counts> positions;
+	for (std::map<IASTNode*, Counts>::const_iterator it = m_nodes.begin(); it != m_nodes.end(); ++it) {
+		const yy::location& location = it->first->get_location();
+		if (!located(location)) continue;
+		Counts& c = positions[Position(std::make_pair(location.begin.line, location.begin.column), it->second.kind)];
+		c.kind = it->second.kind;
+		c.first += it->second.first;
+		c.second += it->second.second;
+		c.name = it->second.name;
+	}
+
+	std::ofstream out(file.c_str());
+	if (!out) return 0;
+	char hash[32];
+	sprintf(hash, "%016llx", hash_file(source));
+	out << header << "\n" << "source " << hash << "\n";
+	std::map<Position, Counts>::const_iterator it;
+	for (it = positions.begin(); it != positions.end(); ++it) {
+		const Counts& c = it->second;
+		if (c.kind == BRANCH) out << "branch";
+		else if (c.kind == LOOP) out << "loop";
+		else out << "call";
+		out << " " << it->first.first.first << ":" << it->first.first.second << " " << c.first;
+		if (c.kind == CALL) out << " " << c.name;
+		else out << " " << c.second;
+		out << "\n";
+	}
+	return out.good();
+}
+
+int PGOProfile::load(const std::string& file, const std::string& source, std::string& error)
+{
+	std::ifstream in(file.c_str());
+	if (!in) {
+		error = "Cannot open profile '" + file + "'";
+		return 0;
+	}
+	std::string line;
+	if (!std::getline(in, line) || line != header) {
+		error = "Profile '" + file + "' has unknown format";
+		return 0;
+	}
+	std::string word, hash;
+	if (!std::getline(in, line) || !(std::istringstream(line) >> word >> hash) || word != "source") {
+		error = "Profile '" + file + "' has no source hash";
+		return 0;
+	}
+	char expected[32];
+	sprintf(expected, "%016llx", hash_file(source));
+	if (hash != expected) {
+		error = "Profile '" + file + "' is stale, source was changed after profiling";
+		return 0;
+	}
+	while (std::getline(in, line)) {
+		std::istringstream fields(line);
+		std::string kind;
+		unsigned int row, column;
+		char colon;
+		Counts c;
+		if (!(fields >> kind >> row >> colon >> column >> c.first) || colon != ':') {
+			error = "Profile '" + file + "' has wrong line: " + line;
+			m_positions.clear();
+			return 0;
+		}
+		if (kind == "branch") c.kind = BRANCH;
+		else if (kind == "loop") c.kind = LOOP;
+		else if (kind == "call") c.kind = CALL;
+		else continue; // written by newer version
+		if (c.kind == CALL) fields >> c.name;
+		else fields >> c.second;
+		m_positions[Position(std::make_pair(row, column), c.kind)] = c;
+	}
+	return 1;
+}
+
+double PGOProfile::branch_probability(const yy::location& location) const
+{
+	if (!located(location)) return -1.0;
+	std::map<Position, Counts>::const_iterator it;
+	it = m_positions.find(Position(std::make_pair(location.begin.line, location.begin.column), BRANCH));
+	if (it == m_positions.end()) return -1.0;
+	unsigned long long total = it->second.first + it->second.second;
+	if (total == 0) return -1.0;
+	return static_cast<double>(it->second.first) / total;
+}
@@ -0,0 +1,64 @@
+#ifndef PGO_PROFILE_H
+#define PGO_PROFILE_H
+
+#include <map>
+#include <string>
+
+#include "location.hh"
+
+class IASTNode;
+
+// runtime behaviour recorded by interpreter for compiler: outcomes of if and ternary
+// conditions, trip counts of while cycles and call site frequencies, keyed by
+// source position; profile of other source is detected by hash of source file
+class PGOProfile
+{
+public:
+	enum Kind { BRANCH, LOOP, CALL };
+	struct Counts
+	{
+		int kind;
+		unsigned long long first; // branch: taken, loop: iterations, call: calls
+		unsigned long long second; // branch: not taken, loop: completed cycles
+		std::string name; // of called function
+		Counts() : kind(BRANCH), first(0), second(0) {}
+	};
+	// line and column of node, kind: condition of ternary and call in it start at same position
+	typedef std::pair<std::pair<unsigned int, unsigned int>, int> Position;
+private:
+	std::map<IASTNode*, Counts> m_nodes; // recorded by interpreter
+	std::map<Position, Counts> m_positions; // loaded
+
+	Counts& counts(IASTNode* node, int kind)
+	{
+		Counts& res = m_nodes[node];
+		res.kind = kind;
+		return res;
+	}
+
+	PGOProfile(const PGOProfile&);
+	const PGOProfile& operator = (const PGOProfile&);
+public:
+	PGOProfile() {}
+	void branch(IASTNode* node, int taken)
+	{
+		Counts& c = counts(node, BRANCH);
+		if (taken) c.first++;
+		else c.second++;
+	}
+	void loop_iteration(IASTNode* node) { counts(node, LOOP).first++; }
+	void loop_end(IASTNode* node) { counts(node, LOOP).second++; }
+	void call(IASTNode* node, const std::string& name)
+	{
+		Counts& c = counts(node, CALL);
+		if (c.first++ == 0) c.name = name;
+	}
+	// return 0 if file can't be written
+	int write(const std::string& file, const std::string& source) const;
+	// return 0 and set error if file can't be read or was recorded for other source
+	int load(const std::string& file, const std::string& source, std::string& error);
+	// probability of true condition at position, -1.0 if unknown
+	double branch_probability(const yy::location& location) const;
+};
+
+#endif // PGO_PROFILE_H
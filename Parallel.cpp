@@ -0,0 +1,137 @@
+#include <new>
+#include <stdexcept>
+
+#include "Parallel.h"
+#include "AbstractSyntaxTree.h"
+#include "Memoization.h"
+#include "ThreadPool.h"
+
+// return 1 if expression doesn't change variables or arrays of its frame
+// and calls only pure functions
+static int is_side_effect_free(IASTNode* node, HashTable& functable, int& has_call)
+{
+	switch (node->get_op()) {
+	case ASSIGN:
+	case POST_INC:
+	case PRE_INC:
+	case POST_DEC:
+	case PRE_DEC:
+	case INDEX: // first access to array creates it
+		return 0;
+	case FUNC_CALL: {
+		ParserFunc* f = functable.get(dynamic_cast<ASTFuncCallNode*>(node)->get_name());
+		if (f == NULL || !f->pure) return 0;
+		has_call = 1;
+		break;
+	}
+	default:
+		break;
+	}
+	for (int i = 0; i < node->child_count(); i++) {
+		if (!is_side_effect_free(node->get_child(i), functable, has_call)) return 0;
+	}
+	return 1;
+}
+
+static void mark_node(IASTNode* node, HashTable& functable)
+{
+	if (node == NULL) return;
+	switch (node->get_op()) {
+	case EQUALITY:
+	case NEQUALITY:
+	case GREATER:
+	case GREATER_EQUAL:
+	case LESS:
+	case LESS_EQUAL:
+	case ADD:
+	case SUB:
+	case MUL:
+	case DIV: {
+		ASTBinaryOpNode* binary = dynamic_cast<ASTBinaryOpNode*>(node);
+		int left_call = 0;
+		int right_call = 0;
+		if (is_side_effect_free(binary->get(0), functable, left_call)
+				&& is_side_effect_free(binary->get(1), functable, right_call)) {
+			binary->set_fork(left_call && right_call);
+		}
+		break;
+	}
+	default:
+		break;
+	}
+	for (int i = 0; i < node->child_count(); i++) {
+		mark_node(node->get_child(i), functable);
+	}
+}
+
+void mark_fork_points(HashTable& functable)
+{
+	mark_pure_functions(functable);
+	std::vector<ParserFunc*> funcs;
+	functable.get_all(funcs);
+	for (unsigned int i = 0; i < funcs.size(); i++) {
+		mark_node(funcs[i]->body, functable);
+	}
+}
+
+// evaluation of one operand in separate interpreter
+class ForkTask : public Task
+{
+	const InterpreterState& m_parent;
+	const ExecutionState& m_frame;
+	IASTNode* m_expr;
+public:
+	double value;
+	double result; // result of last call in operand
+	unsigned long long calls;
+	std::string trace;
+	int failed; // 1 on error, 2 if out of memory
+	std::string error;
+
+	ForkTask(const InterpreterState& parent, const ExecutionState& frame, IASTNode* expr)
+		: m_parent(parent), m_frame(frame), m_expr(expr), value(0.0), result(0.0), calls(0), failed(0)
+	{}
+	void run()
+	{
+		Interpreter interpreter(m_parent, m_frame, m_expr);
+		try {
+			value = interpreter.run();
+		}
+		catch (const std::logic_error& err) {
+			failed = 1;
+			error = err.what();
+		}
+		catch (const std::bad_alloc&) {
+			failed = 2;
+		}
+		result = interpreter.get_exec_state().result;
+		calls = interpreter.get_int_state().calls;
+		trace = interpreter.get_trace();
+	}
+	void rethrow() const
+	{
+		if (failed == 1) throw std::logic_error(error);
+		if (failed == 2) throw std::bad_alloc();
+	}
+};
+
+void run_forked(InterpreterState& int_st, ExecutionState& exec_st, ASTBinaryOpNode* node)
+{
+	// sequential evaluation computes right operand first
+	ForkTask right(int_st, exec_st, node->get(1));
+	ForkTask left(int_st, exec_st, node->get(0));
+	int_st.pool->submit(&right);
+	left.execute();
+	int_st.pool->wait(&right);
+
+	if (int_st.trace != NULL) *int_st.trace << right.trace;
+	right.rethrow();
+	if (int_st.trace != NULL) *int_st.trace << left.trace;
+	left.rethrow();
+
+	int_st.calls += right.calls + left.calls;
+	if (left.calls != 0) exec_st.result = left.result;
+	else if (right.calls != 0) exec_st.result = right.result;
+	int_st.data_stack.push(right.value);
+	int_st.data_stack.push(left.value);
+}
@@ -0,0 +1,17 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "HashTable.h"
+#include "Interpreter.h"
+
+class ASTBinaryOpNode;
+
+// mark binary operations whose operands call functions and have no side effects,
+// such operands can be evaluated in parallel
+void mark_fork_points(HashTable& functable);
+
+// evaluate both operands of node in parallel, push their values in data stack
+// trace, errors and result of last call are the same as in sequential evaluation
+void run_forked(InterpreterState& int_st, ExecutionState& exec_st, ASTBinaryOpNode* node);
+
+#endif // PARALLEL_H
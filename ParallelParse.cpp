@@ -0,0 +1,186 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+#include "ParallelParse.h"
+#include "ParserDriver.h"
+#include "AbstractSyntaxTree.h"
+#include "ThreadPool.h"
+
+static const size_t min_group_size = 16 * 1024; // bytes of source parsed by one task
+
+static int is_name_char(char c)
+{
+	return isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// keyword 'function' at i, not part of longer name
+static int is_function(const char* text, size_t size, size_t i)
+{
+	static const char keyword[] = "function";
+	static const size_t keyword_size = sizeof(keyword) - 1;
+	if (i + keyword_size > size || memcmp(text + i, keyword, keyword_size) != 0) return 0;
+	if (i > 0 && is_name_char(text[i - 1])) return 0;
+	return i + keyword_size == size || !is_name_char(text[i + keyword_size]);
+}
+
+void split_functions(const char* text, size_t size, std::vector<SourceChunk>& chunks)
+{
+	std::vector<SourceChunk> res;
+	SourceChunk chunk;
+	chunk.begin = 0;
+	yy::position position; // as counted by scanner
+	int depth = 0;
+	for (size_t i = 0; i < size; i++) {
+		char c = text[i];
+		if (c == '{') {
+			depth++;
+		} else if (c == '}') {
+			if (--depth < 0) break;
+		} else if (depth == 0 && i > chunk.begin && c == 'f' && is_function(text, size, i)) {
+			chunk.end = i;
+			res.push_back(chunk);
+			chunk.begin = i;
+			chunk.start = position;
+		}
+		if (c == '\n') position.lines(1);
+		else position.columns(1);
+	}
+	chunk.end = size;
+	res.push_back(chunk);
+	if (depth != 0) { // unbalanced braces, parser reports error
+		res.clear();
+		chunk.begin = 0;
+		chunk.start = yy::position();
+		res.push_back(chunk);
+	}
+	chunks.insert(chunks.end(), res.begin(), res.end());
+}
+
+class ChunkTask : public Task
+{
+	const std::string& m_file;
+	const char* m_text;
+	SourceChunk m_chunk;
+public:
+	ParserDriver driver;
+	int result;
+	std::string error; // empty if chunk was parsed
+
+	ChunkTask(const std::string& file, const char* text, const SourceChunk& chunk)
+		: m_file(file), m_text(text), m_chunk(chunk), result(1) {}
+	void run()
+	{
+		try {
+			result = driver.parse(m_file, m_text + m_chunk.begin, m_chunk.end - m_chunk.begin, m_chunk.start);
+		}
+		catch (std::exception& err) {
+			error = err.what();
+		}
+	}
+};
+
+static void shift_ids(IASTNode* node, unsigned int offset)
+{
+	if (node == NULL) return;
+	ASTLeafVar* var = dynamic_cast<ASTLeafVar*>(node);
+	if (var != NULL) var->set(var->get() + offset);
+	for (int i = 0; i < node->child_count(); i++) shift_ids(node->get_child(i), offset);
+}
+
+// parse chunks in parallel, move functions and symbols to driver,
+// return 0 if some chunk has error or function is defined in two chunks, driver
+// is unchanged then and parser of whole file reports error
+static int parse_groups(ParserDriver& driver, const std::string& file, const char* text,
+	const std::vector<SourceChunk>& groups, ThreadPool& pool)
+{
+	MemoryStats::set_shared(); // nodes are allocated by several threads
+	std::vector<ChunkTask*> tasks;
+	for (unsigned int i = 0; i < groups.size(); i++) {
+		tasks.push_back(new ChunkTask(file, text, groups[i]));
+		tasks.back()->driver.fast_scanning = driver.fast_scanning;
+		tasks.back()->driver.fast_scanner.set_simd(driver.fast_scanner.simd());
+		pool.submit(tasks.back());
+	}
+	int res = 1;
+	for (unsigned int i = 0; i < tasks.size(); i++) {
+		pool.wait(tasks[i]);
+		if (tasks[i]->result != 0 || !tasks[i]->error.empty()) res = 0;
+	}
+
+	// ids of symbols are numbered in order of source, as by one parser
+	unsigned int offset = driver.last_index;
+	std::vector<std::string> moved;
+	for (unsigned int i = 0; res && i < tasks.size(); i++) {
+		ParserDriver& part = tasks[i]->driver;
+		std::vector<ParserFunc*> funcs;
+		part.functable.take_all(funcs);
+		for (unsigned int f = 0; f < funcs.size(); f++) {
+			if (driver.functable.get(funcs[f]->name) != NULL) { // defined in other chunk
+				for (; f < funcs.size(); f++) delete funcs[f];
+				res = 0;
+				break;
+			}
+			for (unsigned int a = 0; a < funcs[f]->arg.size(); a++) shift_ids(funcs[f]->arg[a], offset);
+			shift_ids(funcs[f]->body, offset);
+			driver.functable.put(funcs[f]);
+			moved.push_back(funcs[f]->name);
+		}
+		if (!res) break;
+		std::map<unsigned int, std::pair<std::string, unsigned int> >::iterator it;
+		for (it = part.sym_table.begin(); it != part.sym_table.end(); ++it)
+			driver.sym_table[it->first + offset] = it->second;
+		offset += part.last_index;
+	}
+	if (res) {
+		driver.last_index = offset;
+	} else { // functions and symbols of chunks moved before duplicate
+		for (unsigned int i = 0; i < moved.size(); i++) delete driver.functable.remove(moved[i]);
+		driver.sym_table.erase(driver.sym_table.lower_bound(driver.last_index), driver.sym_table.end());
+	}
+	for (unsigned int i = 0; i < tasks.size(); i++) delete tasks[i];
+	return res;
+}
+
+int parse_parallel(ParserDriver& driver, const std::string& file, ThreadPool& pool)
+{
+	if (file == "-" || pool.size() < 2) return driver.parse(file);
+	int fd = open(file.c_str(), O_RDONLY);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+		if (fd >= 0) close(fd);
+		return driver.parse(file);
+	}
+	size_t size = st.st_size;
+	void* addr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED) return driver.parse(file);
+	const char* text = static_cast<const char*>(addr);
+
+	// consecutive functions are grouped, few tasks per worker
+	std::vector<SourceChunk> chunks;
+	split_functions(text, size, chunks);
+	size_t group_size = size / (pool.size() * 4);
+	if (group_size < min_group_size) group_size = min_group_size;
+	std::vector<SourceChunk> groups;
+	for (unsigned int i = 0; i < chunks.size(); i++) {
+		if (!groups.empty() && groups.back().end - groups.back().begin < group_size) groups.back().end = chunks[i].end;
+		else groups.push_back(chunks[i]);
+	}
+
+	int res = 0;
+	try {
+		// parser of whole file reports first error in source order
+		if (groups.size() < 2 || !parse_groups(driver, file, text, groups, pool)) res = driver.parse(file);
+	}
+	catch (...) {
+		munmap(addr, size);
+		throw;
+	}
+	munmap(addr, size);
+	return res;
+}
@@ -0,0 +1,27 @@
+#ifndef PARALLEL_PARSE_H
+#define PARALLEL_PARSE_H
+
+#include <string>
+#include <vector>
+
+#include "location.hh"
+
+class ParserDriver;
+class ThreadPool;
+
+// part of source starting at top level 'function'
+struct SourceChunk
+{
+	size_t begin;
+	size_t end;
+	yy::position start; // of first character
+};
+
+// split text before every 'function' outside of braces, one chunk if text can't be split
+void split_functions(const char* text, size_t size, std::vector<SourceChunk>& chunks);
+
+// parse groups of functions of file on pool and merge them into empty driver,
+// symbol ids and errors are the same as of driver.parse(file)
+int parse_parallel(ParserDriver& driver, const std::string& file, ThreadPool& pool);
+
+#endif // PARALLEL_PARSE_H
@@ -1,27 +1,111 @@
+#include <cstdio>
+#include <sstream>
+
 #include "ParserDriver.h"
 #include "CalcParser.tab.hh"
 
-unsigned int ParserDriver::last_index = 0;
-
 int ParserDriver::parse (const std::string &f)
 {
 	file = f;
-	scan_begin ();
-	yy::CalcParser parser(*this);
-	parser.set_debug_level(trace_parsing);
-	int res = parser.parse();
-	scan_end();
+	start_scanning();
+	return run_parser();
+}
+
+int ParserDriver::parse(const std::string& f, const char* text, size_t size, const yy::position& start)
+{
+	file = f;
+	start_scanning(text, size);
+	location.begin = location.end = start;
+	return run_parser();
+}
+
+// scanner is started, it is stopped even on error
+int ParserDriver::run_parser()
+{
+	int res;
+	scopes.clear(); // left open by error of previous parse
+	try {
+		yy::CalcParser parser(*this);
+		parser.set_debug_level(trace_parsing);
+		res = parser.parse();
+	}
+	catch (...) {
+		stop_scanning();
+		throw;
+	}
+	stop_scanning();
 	return res;
 }
 
+void ParserDriver::start_scanning()
+{
+	if (fast_scanning) fast_scanner.begin(*this);
+	else scan_begin();
+}
+
+void ParserDriver::start_scanning(const char* text, size_t size)
+{
+	if (fast_scanning) fast_scanner.begin(*this, text, size);
+	else scan_begin(text, size);
+}
+
+void ParserDriver::stop_scanning()
+{
+	if (fast_scanning) fast_scanner.end();
+	else scan_end();
+}
+
+unsigned int ParserDriver::tokens(const std::string& f, std::ostream* out)
+{
+	file = f;
+	start_scanning();
+	unsigned int count = 0;
+	try {
+		for (;;) {
+			yy::CalcParser::symbol_type token = yylex(*this);
+			if (out != NULL) {
+				*out << token.location << " " << token.name();
+				if (token.kind() == yy::CalcParser::symbol_kind::S_NAME) *out << " " << names.name(token.value.as<unsigned int>());
+				if (token.kind() == yy::CalcParser::symbol_kind::S_NUMBER) {
+					char value[32]; // exact
+					snprintf(value, sizeof(value), "%.17g", token.value.as<double>());
+					*out << " " << value;
+				}
+				*out << "\n";
+			}
+			count++;
+			if (token.kind() == yy::CalcParser::symbol_kind::S_YYEOF) break;
+		}
+	}
+	catch (...) {
+		stop_scanning();
+		throw;
+	}
+	stop_scanning();
+	return count;
+}
+
+const ScopeTable::Symbol& ParserDriver::declare(unsigned int atom, unsigned int size, bool array)
+{
+	int slot = -1;
+	if (array) {
+		slot = array_lengths.size();
+		array_lengths.push_back(size);
+	}
+	// ids grow, symbol is appended
+	sym_table.insert(sym_table.end(), std::make_pair(last_index, std::make_pair(names.name(atom), size)));
+	return scopes.bind(atom, last_index++, size, slot);
+}
+
+// thrown instead of exit, other programs of process go on
 void ParserDriver::error (const yy::location& l, const std::string& m)
 {
-	std::cerr << l << " : " << m << std::endl;
-	exit(-1);
+	std::ostringstream message;
+	message << l << " : " << m;
+	throw std::logic_error(message.str());
 }
 
 void ParserDriver::error (const std::string& m)
 {
-	std::cerr << m << std::endl;
-	exit(-1);
+	throw std::logic_error(m);
 }
@@ -3,40 +3,84 @@
 
 #include <string>
 #include "HashTable.h"
+#include "Symbols.h"
 #include "CalcParser.tab.hh"
+#include "FastScanner.h"
 #include "Stack.h"
 
-#define YY_DECL yy::CalcParser::symbol_type yylex (ParserDriver& driver)
+// flex scanner is reentrant, its state is kept by driver
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void* yyscan_t;
+#endif
+
+#define YY_DECL yy::CalcParser::symbol_type yylex (ParserDriver& driver, yyscan_t yyscanner)
 
 YY_DECL;
 
 class ParserDriver
 {
 	void scan_begin();
+	// scan copy of text instead of file
+	void scan_begin(const char* text, size_t size);
 	void scan_end();
+	void start_scanning();
+	void start_scanning(const char* text, size_t size);
+	void stop_scanning();
+	int run_parser();
 
 public:
-	ParserDriver() : trace_scanning (false), trace_parsing (false) {}
+	ParserDriver() : last_index(0), trace_scanning (false), trace_parsing (false), fast_scanning(false),
+		scanner(NULL), source_fd(-1), mapped(NULL), mapped_length(0) {}
 
 	HashTable functable;
 
-	std::list<std::map<std::string, unsigned int> > sym_table_stack;
+	Interner names; // values of NAME tokens are atoms
+	ScopeTable scopes; // of function being parsed
 	std::map<unsigned int, std::pair<std::string, unsigned int> > sym_table;
 
-	static unsigned int last_index;
+	unsigned int last_index; // of symbols
+
+	// lengths of arrays of function being parsed, index is frame slot
+	std::vector<unsigned int> array_lengths;
+	// new symbol of innermost scope, size is length of array or 0 for variable,
+	// arrays get frame slot
+	const ScopeTable::Symbol& declare(unsigned int atom, unsigned int size, bool array);
 
 	// set true for debugging
 	bool trace_scanning;
 	bool trace_parsing;
+	// hand-written scanner instead of flex
+	bool fast_scanning;
+	FastScanner fast_scanner;
 
 	std::string file;
 
+	// state of scanner
+	yyscan_t scanner;
+	yy::location location; // of last token
+	int source_fd;
+	char* mapped; // source scanned in place, NULL if source is read by blocks
+	size_t mapped_length;
+
+	// return 0 on success, errors are thrown as std::logic_error
 	int parse(const std::string& f);
+	// parse part of file f, start is position of text in file
+	int parse(const std::string& f, const char* text, size_t size, const yy::position& start);
+	// scan file without parsing, print tokens and their locations to out if it isn't NULL,
+	// return number of tokens
+	unsigned int tokens(const std::string& f, std::ostream* out);
 
 	void error(const yy::location& l, const std::string& m);
 	void error(const std::string& m);
 };
 
+// called by parser
+inline yy::CalcParser::symbol_type yylex(ParserDriver& driver)
+{
+	if (driver.fast_scanning) return driver.fast_scanner.next(driver);
+	return yylex(driver, driver.scanner);
+}
 
 
 #endif // PARSER_DRIVER_H
@@ -1,5 +1,6 @@
 #include "ParserFunc.h"
 #include "AbstractSyntaxTree.h"
+#include "Memoization.h"
 
 ParserFunc::~ParserFunc()
 {
@@ -7,6 +8,10 @@ ParserFunc::~ParserFunc()
 		delete body;
 		body = NULL;
 	}
+	if (memo != NULL) {
+		delete memo;
+		memo = NULL;
+	}
 	for (std::vector<IASTNode*>::iterator it = arg.begin(); it != arg.end(); ++it) {
 		delete *it;
 	}
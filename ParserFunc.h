@@ -5,15 +5,25 @@
 #include <vector>
 #include <string>
 
+#include "MemoryStats.h"
+
 class IASTNode;
+class MemoCache;
+class LazyProgram;
 
 struct ParserFunc
 {
+	MEMORY_TAG(MEM_FUNCTIONS)
 	std::string name;
 	std::vector<IASTNode*> arg;
 	IASTNode* body;
+	std::vector<unsigned int> array_lengths; // lengths of arrays by frame slot
+	int pure; // set by mark_pure_functions()
+	MemoCache* memo; // result cache, NULL if memoization is disabled
+	LazyProgram* lazy; // parses arg and body on first call, NULL if function is parsed
+	unsigned int lazy_index; // of function in lazy program
 
-	ParserFunc() : body(NULL) {}
+	ParserFunc() : body(NULL), pure(0), memo(NULL), lazy(NULL), lazy_index(0) {}
 	~ParserFunc();
 };
 
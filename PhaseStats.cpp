@@ -0,0 +1,165 @@
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include "PhaseStats.h"
+
+PerfCounters::PerfCounters()
+{
+	for (int i = 0; i < COUNT; i++) m_fd[i] = -1;
+}
+
+PerfCounters::~PerfCounters()
+{
+	for (int i = 0; i < COUNT; i++) {
+		if (m_fd[i] >= 0) close(m_fd[i]);
+	}
+}
+
+int PerfCounters::open()
+{
+	static const unsigned long long configs[COUNT] = {
+		PERF_COUNT_HW_CPU_CYCLES,
+		PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_MISSES,
+		PERF_COUNT_HW_BRANCH_MISSES
+	};
+	int opened = 0;
+	for (int i = 0; i < COUNT; i++) {
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = configs[i];
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		// this thread only, on any cpu
+		m_fd[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+		if (m_fd[i] < 0) {
+			if (m_error.empty()) m_error = std::string(name(i)) + ": " + strerror(errno);
+			continue;
+		}
+		opened++;
+	}
+	return opened > 0;
+}
+
+void PerfCounters::read(unsigned long long values[COUNT]) const
+{
+	for (int i = 0; i < COUNT; i++) {
+		values[i] = 0;
+		if (m_fd[i] >= 0 && ::read(m_fd[i], &values[i], sizeof(values[i])) != sizeof(values[i])) values[i] = 0;
+	}
+}
+
+const char* PerfCounters::name(int counter)
+{
+	switch (counter) {
+	case CYCLES: return "cycles";
+	case INSTRUCTIONS: return "instructions";
+	case CACHE_MISSES: return "cache_misses";
+	case BRANCH_MISSES: return "branch_misses";
+	default: return "unknown";
+	}
+}
+
+PhaseStats::PhaseStats(int use_perf) : m_use_perf(use_perf), m_start(0.0)
+{
+	if (m_use_perf) m_perf.open();
+	for (int i = 0; i < PerfCounters::COUNT; i++) m_start_counters[i] = 0;
+}
+
+double PhaseStats::now_ms()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+void PhaseStats::begin(const std::string& name)
+{
+	Phase phase;
+	phase.name = name;
+	phase.wall_ms = -1.0; // not finished
+	m_phases.push_back(phase);
+	if (m_use_perf) m_perf.read(m_start_counters);
+	m_start = now_ms();
+}
+
+void PhaseStats::end()
+{
+	double finish = now_ms();
+	Phase& phase = m_phases.back();
+	phase.wall_ms = finish - m_start;
+	unsigned long long counters[PerfCounters::COUNT];
+	if (m_use_perf) m_perf.read(counters);
+	for (int i = 0; i < PerfCounters::COUNT; i++) {
+		phase.counters[i] = m_use_perf ? counters[i] - m_start_counters[i] : 0;
+	}
+}
+
+static std::string json_string(const std::string& s)
+{
+	std::string res = "\"";
+	for (unsigned int i = 0; i < s.size(); i++) {
+		char c = s[i];
+		if (c == '"' || c == '\\') {
+			res += '\\';
+			res += c;
+		} else if (static_cast<unsigned char>(c) < 0x20) {
+			char buf[8];
+			sprintf(buf, "\\u%04x", c);
+			res += buf;
+		} else {
+			res += c;
+		}
+	}
+	return res + "\"";
+}
+
+void PhaseStats::print_json(std::ostream& out, const std::string& file, const std::string& mode, const std::string& status) const
+{
+	char buf[64];
+	out << "{\"file\": " << json_string(file) << ", \"mode\": " << json_string(mode)
+		<< ", \"status\": " << json_string(status);
+	if (m_use_perf) {
+		out << ", \"perf\": ";
+		if (m_perf.error().empty()) out << "\"ok\"";
+		else out << json_string(m_perf.error());
+	}
+	out << ", \"phases\": [";
+	double total = 0.0;
+	for (unsigned int i = 0; i < m_phases.size(); i++) {
+		const Phase& phase = m_phases[i];
+		if (i > 0) out << ", ";
+		out << "{\"name\": " << json_string(phase.name);
+		if (phase.wall_ms < 0.0) { // interrupted by error
+			out << ", \"wall_ms\": null}";
+			continue;
+		}
+		sprintf(buf, "%.6f", phase.wall_ms);
+		out << ", \"wall_ms\": " << buf;
+		total += phase.wall_ms;
+		for (int c = 0; c < PerfCounters::COUNT; c++) {
+			if (m_use_perf && m_perf.available(c)) out << ", \"" << PerfCounters::name(c) << "\": " << phase.counters[c];
+		}
+		out << "}";
+	}
+	sprintf(buf, "%.6f", total);
+	out << "], \"total_ms\": " << buf;
+	// whole process, including time before first phase
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+		sprintf(buf, "%.3f", usage.ru_utime.tv_sec * 1e3 + usage.ru_utime.tv_usec / 1e3);
+		out << ", \"user_ms\": " << buf;
+		sprintf(buf, "%.3f", usage.ru_stime.tv_sec * 1e3 + usage.ru_stime.tv_usec / 1e3);
+		out << ", \"sys_ms\": " << buf << ", \"max_rss_kb\": " << usage.ru_maxrss;
+	}
+	out << "}" << std::endl;
+}
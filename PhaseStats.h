@@ -0,0 +1,58 @@
+#ifndef PHASE_STATS_H
+#define PHASE_STATS_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+// hardware counters of calling thread, read through perf_event_open()
+class PerfCounters
+{
+public:
+	enum { CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES, COUNT };
+private:
+	int m_fd[COUNT]; // -1 if counter is unavailable
+	std::string m_error;
+
+	PerfCounters(const PerfCounters&);
+	const PerfCounters& operator = (const PerfCounters&);
+public:
+	PerfCounters();
+	~PerfCounters();
+	// return 0 and set error if no counter can be opened
+	int open();
+	int available(int counter) const { return m_fd[counter] >= 0; }
+	const std::string& error() const { return m_error; }
+	// values of all counters, unavailable counters are 0
+	void read(unsigned long long values[COUNT]) const;
+	static const char* name(int counter);
+};
+
+// wall time and counters of pipeline stages, printed as one line of JSON
+class PhaseStats
+{
+	struct Phase
+	{
+		std::string name;
+		double wall_ms;
+		unsigned long long counters[PerfCounters::COUNT];
+	};
+	std::vector<Phase> m_phases;
+	PerfCounters m_perf;
+	int m_use_perf;
+	double m_start; // of current phase
+	unsigned long long m_start_counters[PerfCounters::COUNT];
+
+	static double now_ms();
+
+	PhaseStats(const PhaseStats&);
+	const PhaseStats& operator = (const PhaseStats&);
+public:
+	PhaseStats(int use_perf);
+	void begin(const std::string& name);
+	void end();
+	// status is "ok" or error message
+	void print_json(std::ostream& out, const std::string& file, const std::string& mode, const std::string& status) const;
+};
+
+#endif // PHASE_STATS_H
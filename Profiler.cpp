@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <sstream>
+
+#include "Profiler.h"
+#include "AbstractSyntaxTree.h"
+
+static const char* op_name(int op)
+{
+	switch (op) {
+	case EMPTY: return "empty";
+	case FUNC_CALL: return "call";
+	case STATEMENTS: return "statements";
+	case WHILE_CYCLE: return "while";
+	case IF: return "if";
+	case ASSIGN: return "=";
+	case TERNARY: return "?:";
+	case EQUALITY: return "==";
+	case NEQUALITY: return "!=";
+	case GREATER: return ">";
+	case GREATER_EQUAL: return ">=";
+	case LESS: return "<";
+	case LESS_EQUAL: return "<=";
+	case ADD: return "+";
+	case SUB: return "-";
+	case MUL: return "*";
+	case DIV: return "/";
+	case UNARY_MINUS: return "unary -";
+	case NOT: return "!";
+	case POST_INC: return "x++";
+	case PRE_INC: return "++x";
+	case POST_DEC: return "x--";
+	case PRE_DEC: return "--x";
+	case INDEX: return "[]";
+	case VARIABLE: return "variable";
+	case NUMBER: return "number";
+	case ARRAY_INIT: return "[...]";
+	default: return "unknown";
+	}
+}
+
+static std::string node_name(const NodeProfile* entry)
+{
+	std::ostringstream name;
+	if (entry->node == NULL) {
+		name << "<outside functions>";
+		return name.str();
+	}
+	name << op_name(entry->node->get_op());
+	if (entry->node->get_op() == FUNC_CALL) name << " " << dynamic_cast<ASTFuncCallNode*>(entry->node)->get_name();
+	const yy::location& location = entry->node->get_location();
+	// nodes made by parser itself have empty location
+	if (location.begin.line != location.end.line || location.begin.column != location.end.column) name << " at " << location;
+	name << " in " << entry->owner->name;
+	return name.str();
+}
+
+Profiler::Profiler(HashTable& functable)
+	: m_active(NULL), m_active_size(0), m_active_capacity(0),
+	m_last(0), m_start(0), m_total(0), m_steps(0), m_ns_per_tick(1.0), m_start_ns(0)
+{
+	m_outside.node = NULL;
+	m_outside.owner = NULL;
+	m_outside.body_of = NULL;
+	m_outside.count = m_outside.inclusive = m_outside.exclusive = 0;
+	m_outside.active = 0;
+	m_root.func = NULL;
+	m_root.parent = NULL;
+	m_root.self = 0;
+
+	std::vector<ParserFunc*> funcs;
+	functable.get_all(funcs);
+	for (unsigned int i = 0; i < funcs.size(); i++) {
+		FuncProfile* func = new FuncProfile;
+		func->name = funcs[i]->name;
+		func->calls = func->inclusive = func->exclusive = 0;
+		func->active = 0;
+		m_funcs.push_back(func);
+		if (funcs[i]->body == NULL) continue; // not parsed yet by lazy program
+		add_nodes(funcs[i]->body, func);
+		funcs[i]->body->get_profile()->body_of = func;
+	}
+}
+
+Profiler::~Profiler()
+{
+	for (unsigned int i = 0; i < m_nodes.size(); i++) {
+		m_nodes[i]->node->set_profile(NULL);
+		delete m_nodes[i];
+	}
+	for (unsigned int i = 0; i < m_funcs.size(); i++) {
+		delete m_funcs[i];
+	}
+	for (std::map<FuncProfile*, Path*>::iterator it = m_root.children.begin(); it != m_root.children.end(); ++it) {
+		delete_path(it->second);
+	}
+	delete[] m_active;
+}
+
+void Profiler::delete_path(Path* path)
+{
+	for (std::map<FuncProfile*, Path*>::iterator it = path->children.begin(); it != path->children.end(); ++it) {
+		delete_path(it->second);
+	}
+	delete path;
+}
+
+void Profiler::add_nodes(IASTNode* node, FuncProfile* owner)
+{
+	if (node == NULL) return;
+	NodeProfile* entry = new NodeProfile;
+	entry->node = node;
+	entry->owner = owner;
+	entry->body_of = NULL;
+	entry->count = entry->inclusive = entry->exclusive = 0;
+	entry->active = 0;
+	node->set_profile(entry);
+	m_nodes.push_back(entry);
+	for (int i = 0; i < node->child_count(); i++) {
+		add_nodes(node->get_child(i), owner);
+	}
+}
+
+void Profiler::enter(IASTNode* node, unsigned long long time)
+{
+	NodeProfile* entry = node->get_profile();
+	if (entry == NULL) entry = &m_outside;
+	Path* path = m_active_size == 0 ? &m_root : m_active[m_active_size - 1].path;
+	entry->count++;
+	entry->active++;
+	FuncProfile* func = entry->body_of;
+	if (func != NULL) { // function call, go deeper in call chain
+		func->calls++;
+		func->active++;
+		std::map<FuncProfile*, Path*>::iterator it = path->children.find(func);
+		if (it == path->children.end()) {
+			Path* child = new Path;
+			child->func = func;
+			child->parent = path;
+			child->self = 0;
+			it = path->children.insert(std::make_pair(func, child)).first;
+		}
+		path = it->second;
+	}
+	if (m_active_size == m_active_capacity) {
+		m_active_capacity = m_active_capacity == 0 ? 256 : m_active_capacity * 2;
+		Activation* active = new Activation[m_active_capacity];
+		for (int i = 0; i < m_active_size; i++) active[i] = m_active[i];
+		delete[] m_active;
+		m_active = active;
+	}
+	Activation& activation = m_active[m_active_size++];
+	activation.entry = entry;
+	activation.path = path;
+	activation.start = time;
+}
+
+void Profiler::leave(unsigned long long time)
+{
+	Activation& activation = m_active[--m_active_size];
+	NodeProfile* entry = activation.entry;
+	if (--entry->active == 0) entry->inclusive += time - activation.start;
+	FuncProfile* func = entry->body_of;
+	if (func != NULL && --func->active == 0) func->inclusive += time - activation.start;
+}
+
+void Profiler::start(unsigned long long time)
+{
+	m_start = time;
+	m_start_ns = now_ns();
+}
+
+void Profiler::add_exclusive(const Path* path)
+{
+	if (path->func != NULL) path->func->exclusive += path->self;
+	for (std::map<FuncProfile*, Path*>::const_iterator it = path->children.begin(); it != path->children.end(); ++it) {
+		add_exclusive(it->second);
+	}
+}
+
+void Profiler::finish()
+{
+	if (m_active_size == 0) return;
+	step(NULL, -1); // charge last step and leave everything
+	m_total = m_last - m_start;
+	unsigned long long ticks = now() - m_start;
+	if (ticks > 0) m_ns_per_tick = static_cast<double>(now_ns() - m_start_ns) / ticks;
+	add_exclusive(&m_root);
+}
+
+static bool func_hotter(const FuncProfile* a, const FuncProfile* b)
+{
+	return a->exclusive > b->exclusive;
+}
+
+static bool node_hotter(const NodeProfile* a, const NodeProfile* b)
+{
+	return a->exclusive > b->exclusive;
+}
+
+void Profiler::print_report(std::ostream& out, unsigned int max_nodes) const
+{
+	char line[128];
+	double total = m_total > 0 ? m_total : 1;
+	out << "profile: " << to_ms(m_total) << " ms, " << m_steps << " steps\n";
+
+	std::vector<FuncProfile*> funcs(m_funcs);
+	std::sort(funcs.begin(), funcs.end(), func_hotter);
+	out << "functions:\n";
+	sprintf(line, "%12s %12s %12s %7s  %s\n", "calls", "incl ms", "excl ms", "excl %", "name");
+	out << line;
+	for (unsigned int i = 0; i < funcs.size(); i++) {
+		if (funcs[i]->calls == 0) continue;
+		sprintf(line, "%12llu %12.3f %12.3f %6.2f%%  ", funcs[i]->calls, to_ms(funcs[i]->inclusive),
+			to_ms(funcs[i]->exclusive), 100.0 * funcs[i]->exclusive / total);
+		out << line << funcs[i]->name << "\n";
+	}
+
+	std::vector<NodeProfile*> nodes(m_nodes);
+	std::sort(nodes.begin(), nodes.end(), node_hotter);
+	out << "nodes:\n";
+	sprintf(line, "%12s %12s %12s %7s  %s\n", "count", "incl ms", "excl ms", "excl %", "node");
+	out << line;
+	for (unsigned int i = 0; i < nodes.size() && i < max_nodes; i++) {
+		if (nodes[i]->count == 0) break;
+		sprintf(line, "%12llu %12.3f %12.3f %6.2f%%  ", nodes[i]->count, to_ms(nodes[i]->inclusive),
+			to_ms(nodes[i]->exclusive), 100.0 * nodes[i]->exclusive / total);
+		out << line << node_name(nodes[i]) << "\n";
+	}
+}
+
+void Profiler::print_folded_path(std::ostream& out, const Path* path, const std::string& prefix) const
+{
+	std::string name = prefix.empty() ? path->func->name : prefix + ";" + path->func->name;
+	unsigned long long self_ns = static_cast<unsigned long long>(path->self * m_ns_per_tick + 0.5);
+	if (self_ns > 0) out << name << " " << self_ns << "\n";
+	for (std::map<FuncProfile*, Path*>::const_iterator it = path->children.begin(); it != path->children.end(); ++it) {
+		print_folded_path(out, it->second, name);
+	}
+}
+
+void Profiler::print_folded(std::ostream& out) const
+{
+	for (std::map<FuncProfile*, Path*>::const_iterator it = m_root.children.begin(); it != m_root.children.end(); ++it) {
+		print_folded_path(out, it->second, "");
+	}
+}
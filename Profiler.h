@@ -0,0 +1,127 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <ctime>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "HashTable.h"
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+class IASTNode;
+
+// times are in clock ticks, inclusive time counts outermost activations only,
+// so recursion doesn't count time twice
+struct FuncProfile
+{
+	std::string name;
+	unsigned long long calls;
+	unsigned long long inclusive;
+	unsigned long long exclusive;
+	int active; // activations in progress
+};
+
+struct NodeProfile
+{
+	IASTNode* node;
+	FuncProfile* owner; // function containing node
+	FuncProfile* body_of; // function whose body is node, else NULL
+	unsigned long long count;
+	unsigned long long inclusive;
+	unsigned long long exclusive;
+	int active;
+};
+
+// instrumenting profiler, interpreter reports every step to it,
+// entry and exit of nodes are found by changes of command stack depth
+class Profiler
+{
+	// chain of function calls, root has no function
+	struct Path
+	{
+		FuncProfile* func;
+		Path* parent;
+		std::map<FuncProfile*, Path*> children;
+		unsigned long long self; // time spent in func with this chain of callers
+	};
+	struct Activation
+	{
+		NodeProfile* entry;
+		Path* path;
+		unsigned long long start;
+	};
+
+	std::vector<FuncProfile*> m_funcs;
+	std::vector<NodeProfile*> m_nodes;
+	NodeProfile m_outside; // nodes not belonging to function bodies
+	Path m_root;
+	Activation* m_active; // stack of activations, one per command stack entry
+	int m_active_size;
+	int m_active_capacity;
+	unsigned long long m_last; // time of last step
+	unsigned long long m_start;
+	unsigned long long m_total;
+	unsigned long long m_steps;
+	double m_ns_per_tick;
+	unsigned long long m_start_ns;
+
+	// time stamp counter is much cheaper than clock_gettime() in every step
+	static unsigned long long now()
+	{
+#if defined(__i386__) || defined(__x86_64__)
+		return __rdtsc();
+#else
+		return now_ns();
+#endif
+	}
+	static unsigned long long now_ns()
+	{
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	}
+	void add_nodes(IASTNode* node, FuncProfile* owner);
+	void enter(IASTNode* node, unsigned long long time);
+	void leave(unsigned long long time);
+	void start(unsigned long long time);
+	void add_exclusive(const Path* path);
+	double to_ms(unsigned long long ticks) const { return ticks * m_ns_per_tick / 1e6; }
+	static void delete_path(Path* path);
+	void print_folded_path(std::ostream& out, const Path* path, const std::string& prefix) const;
+
+	Profiler(const Profiler&);
+	const Profiler& operator = (const Profiler&);
+public:
+	Profiler(HashTable& functable);
+	~Profiler();
+	// called before every step of interpreter, depth is size of command stack
+	void step(IASTNode* node, int depth)
+	{
+		unsigned long long time = now();
+		if (m_active_size > 0) {
+			Activation* last = &m_active[m_active_size - 1];
+			unsigned long long spent = time - m_last;
+			last->entry->exclusive += spent;
+			last->path->self += spent;
+		} else {
+			start(time);
+		}
+		m_last = time;
+		m_steps++;
+		while (m_active_size > depth + 1) leave(time);
+		if (m_active_size < depth + 1) enter(node, time);
+	}
+	// close activations left by end of execution or error
+	void finish();
+	// functions and max_nodes hottest nodes sorted by exclusive time
+	void print_report(std::ostream& out, unsigned int max_nodes) const;
+	// one line "main;f;g nanoseconds" per call chain, input of flame graph tools
+	void print_folded(std::ostream& out) const;
+};
+
+#endif // PROFILER_H
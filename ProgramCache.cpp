@@ -0,0 +1,372 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <typeinfo>
+
+#include "ProgramCache.h"
+#include "ParserDriver.h"
+#include "AbstractSyntaxTree.h"
+#include "HelpTools.h"
+
+static int kind_of(IASTNode* node)
+{
+	const std::type_info& type = typeid(*node);
+	if (type == typeid(ASTEmptyNode)) return ProgramCache::EMPTY_NODE;
+	if (type == typeid(ASTUnaryOpNode)) return ProgramCache::UNARY;
+	if (type == typeid(ASTBinaryOpNode)) return ProgramCache::BINARY;
+	if (type == typeid(ASTIndexNode)) return ProgramCache::INDEX;
+	if (type == typeid(ASTAssignNode)) return ProgramCache::ASSIGN;
+	if (type == typeid(ASTTernaryOpNode)) return ProgramCache::TERNARY;
+	if (type == typeid(ASTNoRetBinaryOpNode)) return ProgramCache::NORET_BINARY;
+	if (type == typeid(ASTNoRetTernaryOpNode)) return ProgramCache::NORET_TERNARY;
+	if (type == typeid(ASTLeafVar)) return ProgramCache::LEAF_VAR;
+	if (type == typeid(ASTLeafNum)) return ProgramCache::LEAF_NUM;
+	if (type == typeid(ASTIncrOpNode)) return ProgramCache::INCR;
+	if (type == typeid(ASTFuncCallNode)) return ProgramCache::FUNC_CALL;
+	if (type == typeid(ASTArrayInitNode)) return ProgramCache::ARRAY_INIT;
+	return -1;
+}
+
+// number of children every kind is made with, -1 for any
+static int children_of(unsigned int kind)
+{
+	switch (kind) {
+	case ProgramCache::EMPTY_NODE: case ProgramCache::LEAF_VAR: case ProgramCache::LEAF_NUM: return 0;
+	case ProgramCache::UNARY: case ProgramCache::INCR: case ProgramCache::ARRAY_INIT: return 1;
+	case ProgramCache::TERNARY: case ProgramCache::NORET_TERNARY: return 3;
+	case ProgramCache::FUNC_CALL: return -1;
+	default: return 2;
+	}
+}
+
+// number + 1 of node referred before count and by no one else, parents delete their children
+static int own(std::vector<char>& used, unsigned int number, unsigned int count)
+{
+	if (number == 0 || number > count || used[number - 1]) return 0;
+	used[number - 1] = 1;
+	return 1;
+}
+
+unsigned int ProgramCache::record_sizes()
+{
+	return sizeof(NodeRecord) << 16 | sizeof(FuncRecord) << 8 | sizeof(SymbolRecord);
+}
+
+std::string ProgramCache::entry(unsigned long long hash) const
+{
+	char name[32];
+	sprintf(name, "/%016llx.calcc", hash);
+	return m_dir + name;
+}
+
+unsigned int ProgramCache::add_string(const std::string& str)
+{
+	unsigned int offset = m_strings.size();
+	m_strings.append(str.c_str(), str.size() + 1);
+	return offset;
+}
+
+unsigned int ProgramCache::add_node(IASTNode* node)
+{
+	if (node == NULL) return 0;
+	int kind = kind_of(node);
+	if (kind < 0) return 0;
+
+	std::vector<unsigned int> children;
+	for (int i = 0; i < node->child_count(); i++) {
+		unsigned int number = add_node(node->get_child(i));
+		if (number == 0) return 0;
+		children.push_back(number);
+	}
+
+	NodeRecord record;
+	memset(&record, 0, sizeof(record));
+	record.kind = kind;
+	record.op = node->get_op();
+	record.children = m_index.size();
+	record.child_count = children.size();
+	m_index.insert(m_index.end(), children.begin(), children.end());
+	if (kind == LEAF_VAR) {
+		record.id = static_cast<ASTLeafVar*>(node)->get();
+		record.slot = static_cast<ASTLeafVar*>(node)->get_slot();
+	} else if (kind == INDEX) {
+		record.slot = static_cast<ASTIndexNode*>(node)->get_slot();
+	} else if (kind == LEAF_NUM) {
+		record.value = static_cast<ASTLeafNum*>(node)->get();
+	} else if (kind == FUNC_CALL) {
+		record.id = add_string(static_cast<ASTFuncCallNode*>(node)->get_name());
+	} else if (kind == ARRAY_INIT) {
+		const std::vector<double>& values = static_cast<ASTArrayInitNode*>(node)->values();
+		record.id = m_values.size();
+		m_values.push_back(values.size());
+		m_values.insert(m_values.end(), values.begin(), values.end());
+	}
+	const yy::location& location = node->get_location();
+	record.location[0] = location.begin.line;
+	record.location[1] = location.begin.column;
+	record.location[2] = location.end.line;
+	record.location[3] = location.end.column;
+	m_nodes.push_back(record);
+	return m_nodes.size();
+}
+
+int ProgramCache::store(const std::string& source, const ParserDriver& driver)
+{
+	struct stat st;
+	if (stat(source.c_str(), &st) != 0) return 0;
+	unsigned long long hash = hash_file(source);
+	m_nodes.clear();
+	m_index.clear();
+	m_values.clear();
+	m_strings.clear();
+
+	std::vector<ParserFunc*> funcs;
+	driver.functable.get_all(funcs);
+	std::vector<FuncRecord> func_records;
+	for (unsigned int i = 0; i < funcs.size(); i++) {
+		FuncRecord record;
+		record.name = add_string(funcs[i]->name);
+		std::vector<unsigned int> args;
+		for (unsigned int a = 0; a < funcs[i]->arg.size(); a++) {
+			args.push_back(add_node(funcs[i]->arg[a]));
+			if (args.back() == 0) return 0;
+		}
+		record.body = add_node(funcs[i]->body);
+		if (record.body == 0) return 0;
+		record.args = m_index.size();
+		record.arg_count = args.size();
+		m_index.insert(m_index.end(), args.begin(), args.end());
+		record.arrays = m_index.size();
+		record.array_count = funcs[i]->array_lengths.size();
+		m_index.insert(m_index.end(), funcs[i]->array_lengths.begin(), funcs[i]->array_lengths.end());
+		func_records.push_back(record);
+	}
+	std::vector<SymbolRecord> symbols;
+	std::map<unsigned int, std::pair<std::string, unsigned int> >::const_iterator it;
+	for (it = driver.sym_table.begin(); it != driver.sym_table.end(); ++it) {
+		SymbolRecord record;
+		record.id = it->first;
+		record.size = it->second.second;
+		record.name = add_string(it->second.first);
+		symbols.push_back(record);
+	}
+
+	Header header;
+	memset(&header, 0, sizeof(header));
+	header.magic = magic;
+	header.version = version;
+	header.byte_order = byte_order;
+	header.record_sizes = record_sizes();
+	header.source_hash = hash;
+	header.source_size = st.st_size;
+	header.node_count = m_nodes.size();
+	header.func_count = func_records.size();
+	header.symbol_count = symbols.size();
+	header.index_count = m_index.size();
+	header.value_count = m_values.size();
+	header.string_size = m_strings.size();
+	header.last_index = driver.last_index;
+	// nodes first, they need the strictest alignment
+	header.nodes = sizeof(Header);
+	header.values = header.nodes + m_nodes.size() * sizeof(NodeRecord);
+	header.funcs = header.values + m_values.size() * sizeof(double);
+	header.symbols = header.funcs + func_records.size() * sizeof(FuncRecord);
+	header.index = header.symbols + symbols.size() * sizeof(SymbolRecord);
+	header.strings = header.index + m_index.size() * sizeof(unsigned int);
+
+	// readers see old entry or complete new one
+	char suffix[32];
+	sprintf(suffix, ".%d.tmp", static_cast<int>(getpid()));
+	std::string file = entry(hash);
+	std::string temp = file + suffix;
+	FILE* out = fopen(temp.c_str(), "wb");
+	if (out == NULL) return 0;
+	fwrite(&header, sizeof(header), 1, out);
+	if (!m_nodes.empty()) fwrite(&m_nodes[0], sizeof(NodeRecord), m_nodes.size(), out);
+	if (!m_values.empty()) fwrite(&m_values[0], sizeof(double), m_values.size(), out);
+	if (!func_records.empty()) fwrite(&func_records[0], sizeof(FuncRecord), func_records.size(), out);
+	if (!symbols.empty()) fwrite(&symbols[0], sizeof(SymbolRecord), symbols.size(), out);
+	if (!m_index.empty()) fwrite(&m_index[0], sizeof(unsigned int), m_index.size(), out);
+	fwrite(m_strings.data(), 1, m_strings.size(), out);
+	int res = !ferror(out);
+	res = fclose(out) == 0 && res;
+	if (res) res = rename(temp.c_str(), file.c_str()) == 0;
+	if (!res) unlink(temp.c_str());
+	return res;
+}
+
+int ProgramCache::valid(const char* data, unsigned long long size, unsigned long long hash, unsigned long long source_size)
+{
+	if (size < sizeof(Header)) return 0;
+	const Header& h = *reinterpret_cast<const Header*>(data);
+	if (h.magic != magic || h.version != version || h.byte_order != byte_order || h.record_sizes != record_sizes()) return 0;
+	if (h.source_hash != hash || h.source_size != source_size) return 0;
+	if (h.nodes != sizeof(Header)
+		|| h.values != h.nodes + 1ULL * h.node_count * sizeof(NodeRecord)
+		|| h.funcs != h.values + 1ULL * h.value_count * sizeof(double)
+		|| h.symbols != h.funcs + 1ULL * h.func_count * sizeof(FuncRecord)
+		|| h.index != h.symbols + 1ULL * h.symbol_count * sizeof(SymbolRecord)
+		|| h.strings != h.index + 1ULL * h.index_count * sizeof(unsigned int)
+		|| h.strings + h.string_size != size) return 0;
+	if (h.string_size > 0 && data[size - 1] != '\0') return 0; // every string is terminated
+
+	const NodeRecord* nodes = reinterpret_cast<const NodeRecord*>(data + h.nodes);
+	const double* values = reinterpret_cast<const double*>(data + h.values);
+	const FuncRecord* funcs = reinterpret_cast<const FuncRecord*>(data + h.funcs);
+	const SymbolRecord* symbols = reinterpret_cast<const SymbolRecord*>(data + h.symbols);
+	const unsigned int* index = reinterpret_cast<const unsigned int*>(data + h.index);
+	std::vector<char> used(h.node_count, 0);
+	for (unsigned int i = 0; i < h.node_count; i++) {
+		const NodeRecord& n = nodes[i];
+		if (n.kind >= KIND_COUNT) return 0;
+		if (1ULL * n.children + n.child_count > h.index_count) return 0;
+		int count = children_of(n.kind);
+		if (count >= 0 && n.child_count != static_cast<unsigned int>(count)) return 0;
+		for (unsigned int c = 0; c < n.child_count; c++)
+			if (!own(used, index[n.children + c], i)) return 0;
+		if (n.kind == FUNC_CALL && n.id >= h.string_size) return 0;
+		if (n.kind == ARRAY_INIT) {
+			if (n.id >= h.value_count) return 0;
+			double count = values[n.id];
+			if (!(count >= 0.0 && count <= h.value_count - n.id - 1) || count != static_cast<unsigned int>(count)) return 0;
+		}
+	}
+	for (unsigned int i = 0; i < h.func_count; i++) {
+		const FuncRecord& f = funcs[i];
+		if (f.name >= h.string_size || !own(used, f.body, h.node_count)) return 0;
+		if (1ULL * f.args + f.arg_count > h.index_count || 1ULL * f.arrays + f.array_count > h.index_count) return 0;
+		for (unsigned int a = 0; a < f.arg_count; a++)
+			if (!own(used, index[f.args + a], h.node_count)) return 0;
+	}
+	for (unsigned int i = 0; i < h.symbol_count; i++)
+		if (symbols[i].name >= h.string_size) return 0;
+	return 1;
+}
+
+IASTNode* ProgramCache::make_node(const NodeRecord& record, const unsigned int* index, const double* values,
+	const char* strings, const std::vector<IASTNode*>& nodes)
+{
+	IASTNode* child[3] = { NULL, NULL, NULL };
+	for (unsigned int c = 0; c < record.child_count && c < 3; c++)
+		child[c] = nodes[index[record.children + c] - 1];
+
+	IASTNode* res = NULL;
+	switch (record.kind) {
+	case EMPTY_NODE: res = new ASTEmptyNode(); break;
+	case UNARY: {
+		ASTUnaryOpNode* node = new ASTUnaryOpNode(record.op);
+		node->set(child[0]);
+		res = node;
+		break;
+	}
+	case BINARY: case ASSIGN: case NORET_BINARY: {
+		ASTBinaryOpNode* node;
+		if (record.kind == BINARY) node = new ASTBinaryOpNode(record.op);
+		else if (record.kind == ASSIGN) node = new ASTAssignNode();
+		else node = new ASTNoRetBinaryOpNode(record.op);
+		node->set(child[0], child[1]);
+		res = node;
+		break;
+	}
+	case INDEX: {
+		ASTIndexNode* node = new ASTIndexNode();
+		node->set(child[0], child[1]);
+		node->set_slot(record.slot);
+		res = node;
+		break;
+	}
+	case TERNARY: case NORET_TERNARY: {
+		ASTTernaryOpNode* node;
+		if (record.kind == TERNARY) node = new ASTTernaryOpNode(record.op);
+		else node = new ASTNoRetTernaryOpNode(record.op);
+		node->set(child[0], child[1], child[2]);
+		res = node;
+		break;
+	}
+	case LEAF_VAR: res = new ASTLeafVar(record.id, record.slot); break;
+	case LEAF_NUM: res = new ASTLeafNum(record.value); break;
+	case INCR: {
+		ASTIncrOpNode* node = new ASTIncrOpNode(record.op);
+		node->set(child[0]);
+		res = node;
+		break;
+	}
+	case FUNC_CALL: {
+		ASTFuncCallNode* node = new ASTFuncCallNode(strings + record.id);
+		for (unsigned int c = 0; c < record.child_count; c++)
+			node->set_args(nodes[index[record.children + c] - 1]);
+		res = node;
+		break;
+	}
+	case ARRAY_INIT: {
+		ASTArrayInitNode* node = new ASTArrayInitNode(child[0]);
+		const double* first = values + record.id + 1;
+		node->values().assign(first, first + static_cast<unsigned int>(values[record.id]));
+		res = node;
+		break;
+	}
+	default:
+		calc_unreachable("Unknown node in program cache");
+	}
+	res->set_op(record.op);
+	yy::location location;
+	location.begin.line = record.location[0];
+	location.begin.column = record.location[1];
+	location.end.line = record.location[2];
+	location.end.column = record.location[3];
+	res->set_location(location);
+	return res;
+}
+
+int ProgramCache::load(const std::string& source, ParserDriver& driver)
+{
+	struct stat st;
+	if (stat(source.c_str(), &st) != 0) return 0;
+	unsigned long long hash = hash_file(source);
+	int fd = open(entry(hash).c_str(), O_RDONLY);
+	if (fd < 0) return 0;
+	struct stat cached;
+	if (fstat(fd, &cached) != 0 || cached.st_size == 0) {
+		close(fd);
+		return 0;
+	}
+	void* addr = mmap(NULL, cached.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED) return 0;
+	const char* data = static_cast<const char*>(addr);
+	if (!valid(data, cached.st_size, hash, st.st_size)) {
+		munmap(addr, cached.st_size);
+		return 0;
+	}
+
+	// nothing can fail after validation
+	const Header& h = *reinterpret_cast<const Header*>(data);
+	const NodeRecord* node_records = reinterpret_cast<const NodeRecord*>(data + h.nodes);
+	const double* values = reinterpret_cast<const double*>(data + h.values);
+	const FuncRecord* funcs = reinterpret_cast<const FuncRecord*>(data + h.funcs);
+	const SymbolRecord* symbols = reinterpret_cast<const SymbolRecord*>(data + h.symbols);
+	const unsigned int* index = reinterpret_cast<const unsigned int*>(data + h.index);
+	const char* strings = data + h.strings;
+	std::vector<IASTNode*> nodes;
+	nodes.reserve(h.node_count);
+	for (unsigned int i = 0; i < h.node_count; i++)
+		nodes.push_back(make_node(node_records[i], index, values, strings, nodes));
+	for (unsigned int i = 0; i < h.func_count; i++) {
+		ParserFunc* pf = new ParserFunc;
+		pf->name = strings + funcs[i].name;
+		for (unsigned int a = 0; a < funcs[i].arg_count; a++)
+			pf->arg.push_back(nodes[index[funcs[i].args + a] - 1]);
+		pf->body = nodes[funcs[i].body - 1];
+		pf->array_lengths.assign(index + funcs[i].arrays, index + funcs[i].arrays + funcs[i].array_count);
+		driver.functable.put(pf);
+	}
+	for (unsigned int i = 0; i < h.symbol_count; i++)
+		driver.sym_table[symbols[i].id] = std::make_pair(std::string(strings + symbols[i].name), symbols[i].size);
+	if (driver.last_index < h.last_index) driver.last_index = h.last_index;
+	driver.file = source;
+	munmap(addr, cached.st_size);
+	return 1;
+}
@@ -0,0 +1,104 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <string>
+#include <vector>
+
+class IASTNode;
+class ParserDriver;
+
+// parsed programs stored in directory as files "<hash of source>.calcc" and loaded
+// instead of parsing while source is unchanged; records refer to each other by
+// index, so file is used through one mmap without pointer fixups
+class ProgramCache
+{
+public:
+	static const unsigned int magic = 0x63616c63; // "calc"
+	static const unsigned int version = 2;
+	static const unsigned int byte_order = 0x01020304; // as stored by writing machine
+
+	enum Kind { EMPTY_NODE, UNARY, BINARY, INDEX, ASSIGN, TERNARY, NORET_BINARY, NORET_TERNARY,
+		LEAF_VAR, LEAF_NUM, INCR, FUNC_CALL, ARRAY_INIT, KIND_COUNT };
+
+	struct Header
+	{
+		unsigned int magic;
+		unsigned int version;
+		unsigned int byte_order;
+		unsigned int record_sizes; // of node, function and symbol records, changed by other compiler
+		unsigned long long source_hash;
+		unsigned long long source_size;
+		unsigned int node_count;
+		unsigned int func_count;
+		unsigned int symbol_count;
+		unsigned int index_count;
+		unsigned int value_count;
+		unsigned int string_size;
+		unsigned int last_index; // of parser
+		// sections, offsets from start of file
+		unsigned long long nodes;
+		unsigned long long values;
+		unsigned long long funcs;
+		unsigned long long symbols;
+		unsigned long long index;
+		unsigned long long strings;
+	};
+	// children are stored before parent
+	struct NodeRecord
+	{
+		unsigned int kind;
+		int op;
+		unsigned int children; // first in index table, node numbers + 1
+		unsigned int child_count;
+		// variable id, string offset of called function name or value offset of array init list
+		unsigned int id;
+		int slot;
+		int location[4]; // begin line and column, end line and column
+		double value;
+	};
+	struct FuncRecord
+	{
+		unsigned int name; // string offset
+		unsigned int body; // node number + 1
+		unsigned int args; // first in index table, node numbers + 1
+		unsigned int arg_count;
+		unsigned int arrays; // first in index table, lengths of arrays
+		unsigned int array_count;
+	};
+	struct SymbolRecord
+	{
+		unsigned int id;
+		unsigned int size; // of array, 0 for variable
+		unsigned int name; // string offset
+	};
+private:
+	std::string m_dir;
+
+	// buffers of store()
+	std::vector<NodeRecord> m_nodes;
+	std::vector<unsigned int> m_index;
+	std::vector<double> m_values; // number of values of init list followed by values
+	std::string m_strings;
+
+	unsigned int add_string(const std::string& str);
+	// return node number + 1, 0 if node or its child has unknown type or is NULL
+	unsigned int add_node(IASTNode* node);
+	// return 0 if file is damaged or was written for other source
+	static int valid(const char* data, unsigned long long size, unsigned long long hash, unsigned long long source_size);
+	static IASTNode* make_node(const NodeRecord& record, const unsigned int* index, const double* values,
+		const char* strings, const std::vector<IASTNode*>& nodes);
+	static unsigned int record_sizes();
+
+	ProgramCache(const ProgramCache&);
+	const ProgramCache& operator = (const ProgramCache&);
+public:
+	ProgramCache(const std::string& dir) : m_dir(dir) {}
+	// file of source with hash in cache
+	std::string entry(unsigned long long hash) const;
+	// fill empty driver with stored program, return 0 if there is no valid entry
+	int load(const std::string& source, ParserDriver& driver);
+	// return 0 if entry can't be written
+	int store(const std::string& source, const ParserDriver& driver);
+};
+
+#endif // PROGRAM_CACHE_H
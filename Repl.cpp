@@ -0,0 +1,247 @@
+#include <time.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <map>
+#include <set>
+#include <stdexcept>
+
+#include "Repl.h"
+#include "HelpTools.h"
+#include "Interpreter.h"
+#include "Memoization.h"
+#include "Simplify.h"
+
+// temporary function evaluating expression, user can't define function of this name
+static const char* const expression_function = "<expression>";
+
+static int is_blank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static std::string strip(const std::string& text)
+{
+	size_t begin = 0;
+	size_t end = text.size();
+	while (begin < end && is_blank(text[begin])) begin++;
+	while (end > begin && is_blank(text[end - 1])) end--;
+	return text.substr(begin, end - begin);
+}
+
+static int is_name_char(char c)
+{
+	return isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// text starts with keyword function, not with name like functions
+static int is_definition(const std::string& text)
+{
+	return text.compare(0, 8, "function") == 0 && (text.size() == 8 || !is_name_char(text[8]));
+}
+
+static double now_ms()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static int by_name(const ParserFunc* a, const ParserFunc* b)
+{
+	return a->name < b->name;
+}
+
+void Repl::merge(ParserDriver& part, std::ostream& out)
+{
+	std::vector<ParserFunc*> funcs;
+	part.functable.take_all(funcs);
+	std::sort(funcs.begin(), funcs.end(), by_name);
+	std::vector<std::string> replaced;
+	for (unsigned int i = 0; i < funcs.size(); i++) {
+		if (m_simplify) simplify_function(funcs[i]);
+		ParserFunc* old = m_driver.functable.remove(funcs[i]->name);
+		if (old != NULL) {
+			replaced.push_back(funcs[i]->name);
+			delete old;
+		}
+		m_driver.functable.put(funcs[i]);
+		out << (old != NULL ? "replaced " : "defined ") << funcs[i]->name << std::endl;
+	}
+	m_driver.sym_table.insert(part.sym_table.begin(), part.sym_table.end());
+	m_driver.last_index = part.last_index;
+
+	// cached results of functions using replaced ones are stale, other caches are kept
+	std::vector<std::string> stale(replaced);
+	callers(stale);
+	std::sort(stale.begin(), stale.end());
+	for (unsigned int i = 0; i < stale.size(); i++) {
+		ParserFunc* f = m_driver.functable.get(stale[i]);
+		if (f == NULL || f->memo == NULL) continue;
+		if (f->memo->size() > 0) out << "dropped cached results of " << f->name << std::endl;
+		delete f->memo;
+		f->memo = NULL;
+	}
+}
+
+void Repl::callers(std::vector<std::string>& names) const
+{
+	std::vector<ParserFunc*> funcs;
+	m_driver.functable.get_all(funcs);
+	std::vector<std::vector<std::string> > calls(funcs.size());
+	for (unsigned int i = 0; i < funcs.size(); i++) collect_calls(funcs[i]->body, calls[i]);
+
+	std::set<std::string> found(names.begin(), names.end());
+	int changed = 1;
+	while (changed) {
+		changed = 0;
+		for (unsigned int i = 0; i < funcs.size(); i++) {
+			if (found.count(funcs[i]->name) != 0) continue;
+			for (unsigned int k = 0; k < calls[i].size(); k++) {
+				if (found.count(calls[i][k]) == 0) continue;
+				found.insert(funcs[i]->name);
+				names.push_back(funcs[i]->name);
+				changed = 1;
+				break;
+			}
+		}
+	}
+}
+
+double Repl::evaluate(const std::string& expression, std::ostream& out)
+{
+	// expression is assigned to result of function without arguments, header is on
+	// line of expression to keep line numbers of errors
+	std::string text = "function expression() { result = " + expression + "\n;\n}\n";
+	unsigned int first_index = m_driver.last_index;
+	ParserDriver part;
+	part.last_index = first_index;
+	if (part.parse("<input>", text.data(), text.size(), yy::position())) calc_unreachable("Parser error");
+	std::vector<ParserFunc*> funcs;
+	part.functable.take_all(funcs);
+	if (funcs.size() != 1) { // expression closed wrapper and defined more functions
+		for (unsigned int i = 0; i < funcs.size(); i++) delete funcs[i];
+		calc_unreachable("Expression can't define functions");
+	}
+	ParserFunc* f = funcs[0];
+	f->name = expression_function;
+	if (m_simplify) simplify_function(f);
+	m_driver.functable.put(f);
+	m_driver.sym_table.insert(part.sym_table.begin(), part.sym_table.end());
+
+	double result = 0.0;
+	std::string error;
+	try {
+		Interpreter interpreter(&m_driver.functable, &m_driver.sym_table, expression_function);
+		interpreter.set_trace(m_trace ? &out : NULL);
+		if (m_memo_size > 0) interpreter.enable_memo(m_memo_size);
+		result = interpreter.run();
+	} catch (std::logic_error& err) {
+		error = err.what();
+	}
+	// symbols of expression aren't needed after run
+	delete m_driver.functable.remove(expression_function);
+	m_driver.sym_table.erase(m_driver.sym_table.lower_bound(first_index), m_driver.sym_table.end());
+	if (!error.empty()) throw std::logic_error(error);
+	return result;
+}
+
+int Repl::command(const std::string& line, std::ostream& out)
+{
+	size_t space = line.find_first_of(" \t");
+	std::string name = line.substr(0, space);
+	std::string arg = space == std::string::npos ? "" : strip(line.substr(space));
+	if (name == ":quit" || name == ":q") return 0;
+	if (name == ":load" && !arg.empty()) {
+		load(arg, out);
+	} else if (name == ":functions") {
+		std::vector<ParserFunc*> funcs;
+		m_driver.functable.get_all(funcs);
+		std::sort(funcs.begin(), funcs.end(), by_name);
+		for (unsigned int i = 0; i < funcs.size(); i++) {
+			out << funcs[i]->name << "/" << funcs[i]->arg.size();
+			if (funcs[i]->memo != NULL) out << ", " << funcs[i]->memo->size() << " cached results";
+			out << std::endl;
+		}
+	} else if (name == ":help") {
+		out << "function name(args) { ... }\tdefine or replace function\n";
+		out << "expression\t\t\tevaluate with functions defined so far\n";
+		out << ":load file\t\t\tdefine functions of file\n";
+		out << ":functions\t\t\tlist functions with number of arguments and cached results\n";
+		out << ":quit\t\t\t\tend session" << std::endl;
+	} else {
+		calc_unreachable("Unknown command " + line + ", :help lists commands");
+	}
+	return 1;
+}
+
+void Repl::load(const std::string& file, std::ostream& out)
+{
+	ParserDriver part;
+	part.last_index = m_driver.last_index;
+	if (part.parse(file)) calc_unreachable("Parser error");
+	merge(part, out);
+}
+
+int Repl::execute(const std::string& input, std::ostream& out, std::ostream& err)
+{
+	std::string text = strip(input);
+	if (text.empty()) return 1;
+	double start = now_ms();
+	int go_on = 1;
+	try {
+		if (text[0] == ':') {
+			go_on = command(text, out);
+		} else if (is_definition(text)) {
+			ParserDriver part;
+			part.last_index = m_driver.last_index;
+			if (part.parse("<input>", text.data(), text.size(), yy::position())) calc_unreachable("Parser error");
+			merge(part, out);
+		} else {
+			if (text[text.size() - 1] == ';') text.erase(text.size() - 1);
+			double result = evaluate(text, out);
+			if (!m_trace) out << result << std::endl;
+		}
+	} catch (std::logic_error& error) {
+		out.flush();
+		err << error.what() << std::endl;
+	}
+	if (!go_on) return 0;
+	char buf[32];
+	sprintf(buf, "%.3f", now_ms() - start);
+	err << "(" << buf << " ms)" << std::endl;
+	return 1;
+}
+
+void Repl::run(std::istream& in, std::ostream& out, std::ostream& err, int prompt)
+{
+	// definition is read until its braces are balanced
+	std::string input;
+	std::string line;
+	int depth = 0;
+	int opened = 0;
+	if (prompt) out << "calc> " << std::flush;
+	while (std::getline(in, line)) {
+		input += line;
+		input += '\n';
+		for (unsigned int i = 0; i < line.size(); i++) {
+			if (line[i] == '{') {
+				depth++;
+				opened = 1;
+			} else if (line[i] == '}') {
+				depth--;
+			}
+		}
+		if (depth > 0 || (!opened && is_definition(strip(input)))) {
+			if (prompt) out << "....> " << std::flush;
+			continue;
+		}
+		int go_on = execute(input, out, err);
+		input.clear();
+		depth = 0;
+		opened = 0;
+		if (!go_on) return;
+		if (prompt) out << "calc> " << std::flush;
+	}
+	execute(input, out, err); // unfinished definition is reported by parser
+}
@@ -0,0 +1,44 @@
+#ifndef REPL_H
+#define REPL_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "ParserDriver.h"
+
+// interactive session, functions stay parsed between commands: input is function
+// definitions, which add or replace functions, expressions, which are evaluated with
+// functions defined so far, or commands starting with ':'; results of pure functions
+// are kept between commands and dropped only for callers of replaced functions
+class Repl
+{
+	ParserDriver m_driver; // functions and symbols of session
+	int m_trace;
+	unsigned int m_memo_size; // 0 if memoization is disabled
+	int m_simplify;
+
+	// move functions parsed by part into session, replacing functions of same name
+	void merge(ParserDriver& part, std::ostream& out);
+	// functions calling any of names directly or through other functions, names included
+	void callers(std::vector<std::string>& names) const;
+	double evaluate(const std::string& expression, std::ostream& out);
+	// return 0 for :quit
+	int command(const std::string& line, std::ostream& out);
+
+	Repl(const Repl&);
+	const Repl& operator = (const Repl&);
+public:
+	Repl(int trace, unsigned int memo_size, int simplify)
+		: m_trace(trace), m_memo_size(memo_size), m_simplify(simplify) {}
+	// add functions of file, errors are thrown as std::logic_error
+	void load(const std::string& file, std::ostream& out);
+	// execute complete input, print its output to out, error and latency to err;
+	// return 0 after :quit
+	int execute(const std::string& input, std::ostream& out, std::ostream& err);
+	// read inputs until end of in or :quit, prompt is printed if in is terminal
+	void run(std::istream& in, std::ostream& out, std::ostream& err, int prompt);
+};
+
+#endif // REPL_H
@@ -9,7 +9,9 @@ void SSAList::add(ISSANode* n)
 	}
 }
 
-SSAList::SSAList() : m_start(NULL), m_end(NULL) {}
+SSAList::SSAList() : m_start(NULL), m_end(NULL), m_context(&m_own_context) {}
+
+SSAList::SSAList(SSAList* parent) : m_start(NULL), m_end(NULL), m_context(parent->m_context) {}
 
 SSAList::~SSAList()
 {
@@ -30,7 +32,7 @@ ISSANode* SSAList::get_end() const { return m_end; }
 std::string SSAList::new_name()
 {
 	char buf[20];
-	sprintf(buf, "t_%d", last_name++);
+	sprintf(buf, "t_%d", m_context->last_name++);
 	std::string name = buf;
 	return name;
 }
@@ -136,4 +138,3 @@ void SSATernaryOpNode::make_ssa(std::map<std::string, int>& left_vars, std::map<
 	delete[] temp_num;
 }
 
-int SSAList::last_name = 0;
@@ -9,23 +9,40 @@
 #include <string>
 #include <map>
 #include "HelpTools.h"
+#include "MemoryStats.h"
 
 class ISSANode;
+class PGOProfile;
+
+// state of one compilation, shared by lists of nested blocks
+struct SSAContext
+{
+	int last_name; // of temporaries
+	// names of variables by id, SSA uses names instead of ids
+	const std::map<unsigned int, std::pair<std::string, unsigned int> >* symbols;
+	const PGOProfile* profile; // branch probabilities, NULL if compiled without profile
+
+	SSAContext() : last_name(0), symbols(NULL), profile(NULL) {}
+};
 
 class SSAList
 {
 	ISSANode* m_start;
 	ISSANode* m_end;
-
-	static int last_name;
+	SSAContext m_own_context;
+	SSAContext* m_context; // of top list
 
 	void add(ISSANode* n);
 
 	SSAList(const SSAList&);
 	void operator=(const SSAList&);
 public:
+	MEMORY_TAG(MEM_SSA)
 	SSAList();
+	// list of nested block, shares context with parent
+	explicit SSAList(SSAList* parent);
 	~SSAList();
+	SSAContext& context() { return *m_context; }
 	ISSANode* get_first() const;
 	ISSANode* get_end() const;
 	std::string new_name();
@@ -46,6 +63,7 @@ public:
 class ISSANode
 {
 public:
+	MEMORY_TAG(MEM_SSA)
 	enum operation {
 		UNKNOWN,
 		IF,
@@ -208,9 +226,10 @@ class SSATernaryOpNode : public ISSANode
 	ISSANode* m_child;
 	SSAList* m_true;
 	SSAList* m_false;
+	double m_probability; // of true condition from profile, -1.0 if unknown
 
 public:
-	SSATernaryOpNode(int operation) : ISSANode(operation), m_child(NULL), m_true(NULL), m_false(NULL) {}
+	SSATernaryOpNode(int operation) : ISSANode(operation), m_child(NULL), m_true(NULL), m_false(NULL), m_probability(-1.0) {}
 	~SSATernaryOpNode() {
 		if (m_child != NULL) delete m_child;
 		if (m_true != NULL) delete m_true;
@@ -225,14 +244,29 @@ public:
 	ISSANode* get_cond() const { return m_child; }
 	SSAList* get_true() const { return m_true; }
 	SSAList* get_false() const { return m_false; }
+	void set_probability(double probability) { m_probability = probability; }
 	void print()
 	{
-		std::cout << "if ( ";
+		if (m_probability < 0.0) {
+			std::cout << "if ( ";
+			get_cond()->print();
+			std::cout << " ) {\n";
+			get_true()->print();
+			std::cout << "} else {\n";
+			get_false()->print();
+			std::cout << "}\n";
+			return;
+		}
+		// more frequent block is placed first
+		int swap = m_probability < 0.5;
+		char hint[32];
+		sprintf(hint, " ) [likely %.2f] {\n", swap ? 1.0 - m_probability : m_probability);
+		std::cout << (swap ? "if ( ! " : "if ( ");
 		get_cond()->print();
-		std::cout << " ) {\n";
-		get_true()->print();
+		std::cout << hint;
+		(swap ? get_false() : get_true())->print();
 		std::cout << "} else {\n";
-		get_false()->print();
+		(swap ? get_true() : get_false())->print();
 		std::cout << "}\n";
 	}
 	void make_ssa(std::map<std::string, int>& left_vars, std::map<std::string, int>& right_vars, int change);
@@ -0,0 +1,182 @@
+#include <signal.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <cstdio>
+
+#include "Sampler.h"
+#include "AbstractSyntaxTree.h"
+
+static Sampler* volatile active_sampler = NULL;
+static __thread int sampled_thread = 0;
+static struct sigaction old_action;
+
+Sampler::Sampler(int frequency)
+	: m_depth(0), m_write(0), m_read(0), m_dropped(0), m_exec(NULL), m_samples(0)
+{
+	if (frequency < 1) frequency = 1;
+	m_interval = 1000000 / frequency;
+	if (m_interval < 1) m_interval = 1;
+}
+
+Sampler::~Sampler()
+{
+	stop();
+}
+
+void Sampler::on_signal(int)
+{
+	Sampler* sampler = active_sampler;
+	if (sampler == NULL || !sampled_thread) return; // worker threads of parallel evaluation
+	sampler->record();
+}
+
+// called from signal handler, no allocations and locks
+void Sampler::record()
+{
+	unsigned int write = m_write;
+	if (write - __atomic_load_n(&m_read, __ATOMIC_ACQUIRE) >= ring_size) {
+		m_dropped++;
+		return;
+	}
+	Sample& sample = m_ring[write % ring_size];
+	int depth = m_depth;
+	sample.node = m_exec->command;
+	sample.depth = depth;
+	sample.top = depth > 0 && depth <= max_frames ? m_frames[depth - 1] : NULL;
+	for (int i = 0; i < depth && i < max_sample_frames; i++) {
+		sample.frames[i] = m_frames[i];
+	}
+	__atomic_store_n(&m_write, write + 1, __ATOMIC_RELEASE);
+}
+
+void Sampler::start(const ExecutionState* exec)
+{
+	m_exec = exec;
+	sampled_thread = 1;
+	active_sampler = this;
+
+	struct sigaction action;
+	action.sa_handler = on_signal;
+	sigemptyset(&action.sa_mask);
+	action.sa_flags = SA_RESTART;
+	if (sigaction(SIGPROF, &action, &old_action) != 0) calc_unreachable("Cannot set SIGPROF handler");
+
+	struct itimerval timer;
+	timer.it_interval.tv_sec = m_interval / 1000000;
+	timer.it_interval.tv_usec = m_interval % 1000000;
+	timer.it_value = timer.it_interval;
+	if (setitimer(ITIMER_PROF, &timer, NULL) != 0) calc_unreachable("Cannot start profiling timer");
+}
+
+void Sampler::stop()
+{
+	if (active_sampler != this) return;
+	struct itimerval timer;
+	timer.it_interval.tv_sec = timer.it_interval.tv_usec = 0;
+	timer.it_value = timer.it_interval;
+	setitimer(ITIMER_PROF, &timer, NULL);
+	sigaction(SIGPROF, &old_action, NULL);
+	active_sampler = NULL;
+	sampled_thread = 0;
+	drain();
+}
+
+void Sampler::drain()
+{
+	unsigned int write = __atomic_load_n(&m_write, __ATOMIC_ACQUIRE);
+	while (m_read != write) {
+		const Sample& sample = m_ring[m_read % ring_size];
+		int stored = std::min(sample.depth, static_cast<int>(max_sample_frames));
+		std::vector<ParserFunc*> stack(sample.frames, sample.frames + stored);
+		if (sample.depth > stored) {
+			stack.push_back(NULL); // skipped frames
+			stack.push_back(sample.top);
+		}
+		m_stacks[stack]++;
+		m_nodes[std::make_pair(sample.top, sample.node)]++;
+		m_samples++;
+		__atomic_store_n(&m_read, m_read + 1, __ATOMIC_RELEASE);
+	}
+}
+
+static std::string func_name(const ParserFunc* func)
+{
+	return func == NULL ? "..." : func->name;
+}
+
+static std::string position(const std::pair<ParserFunc*, IASTNode*>& key)
+{
+	char line[32] = "";
+	if (key.second != NULL) {
+		const yy::location& location = key.second->get_location();
+		// nodes made by parser itself have empty location
+		if (location.begin.line != location.end.line || location.begin.column != location.end.column) {
+			sprintf(line, " line %u", location.begin.line);
+		}
+	}
+	return func_name(key.first) + line;
+}
+
+static bool more_samples(const std::pair<std::string, unsigned long long>& a, const std::pair<std::string, unsigned long long>& b)
+{
+	return a.second > b.second;
+}
+
+void Sampler::print_report(std::ostream& out, unsigned int max_nodes) const
+{
+	char line[128];
+	double total = m_samples > 0 ? m_samples : 1;
+	out << "samples: " << m_samples << ", dropped " << m_dropped << ", interval " << m_interval << " us\n";
+
+	// self samples have function on top, total samples have it anywhere in stack
+	std::map<std::string, unsigned long long> self;
+	std::map<std::string, unsigned long long> all;
+	for (std::map<std::vector<ParserFunc*>, unsigned long long>::const_iterator it = m_stacks.begin(); it != m_stacks.end(); ++it) {
+		const std::vector<ParserFunc*>& stack = it->first;
+		if (stack.empty()) continue;
+		self[func_name(stack.back())] += it->second;
+		std::vector<ParserFunc*> seen;
+		for (unsigned int i = 0; i < stack.size(); i++) {
+			if (std::find(seen.begin(), seen.end(), stack[i]) != seen.end()) continue;
+			seen.push_back(stack[i]);
+			all[func_name(stack[i])] += it->second;
+		}
+	}
+	std::vector<std::pair<std::string, unsigned long long> > funcs(all.begin(), all.end());
+	std::sort(funcs.begin(), funcs.end(), more_samples);
+	out << "functions:\n";
+	sprintf(line, "%12s %7s %12s %7s  %s\n", "self", "self %", "total", "total %", "name");
+	out << line;
+	for (unsigned int i = 0; i < funcs.size(); i++) {
+		unsigned long long own = self[funcs[i].first];
+		sprintf(line, "%12llu %6.2f%% %12llu %6.2f%%  ", own, 100.0 * own / total, funcs[i].second, 100.0 * funcs[i].second / total);
+		out << line << funcs[i].first << "\n";
+	}
+
+	std::map<std::string, unsigned long long> positions;
+	for (std::map<std::pair<ParserFunc*, IASTNode*>, unsigned long long>::const_iterator it = m_nodes.begin(); it != m_nodes.end(); ++it) {
+		positions[position(it->first)] += it->second;
+	}
+	std::vector<std::pair<std::string, unsigned long long> > lines(positions.begin(), positions.end());
+	std::sort(lines.begin(), lines.end(), more_samples);
+	out << "lines:\n";
+	sprintf(line, "%12s %7s  %s\n", "samples", "%", "position");
+	out << line;
+	for (unsigned int i = 0; i < lines.size() && i < max_nodes; i++) {
+		sprintf(line, "%12llu %6.2f%%  ", lines[i].second, 100.0 * lines[i].second / total);
+		out << line << lines[i].first << "\n";
+	}
+}
+
+void Sampler::print_folded(std::ostream& out) const
+{
+	for (std::map<std::vector<ParserFunc*>, unsigned long long>::const_iterator it = m_stacks.begin(); it != m_stacks.end(); ++it) {
+		const std::vector<ParserFunc*>& stack = it->first;
+		if (stack.empty()) continue;
+		for (unsigned int i = 0; i < stack.size(); i++) {
+			if (i > 0) out << ";";
+			out << func_name(stack[i]);
+		}
+		out << " " << it->second << "\n";
+	}
+}
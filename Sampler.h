@@ -0,0 +1,73 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "ParserFunc.h"
+
+struct ExecutionState;
+class IASTNode;
+
+// sampling profiler, SIGPROF handler copies current node and shadow call stack
+// to ring buffer, interpreter drains buffer between steps and aggregates samples
+// only thread which called start() is sampled
+class Sampler
+{
+public:
+	static const int max_frames = 4096; // deeper frames are counted, not stored
+	static const int max_sample_frames = 64; // outermost frames kept in sample
+	static const unsigned int ring_size = 256;
+private:
+	struct Sample
+	{
+		IASTNode* node;
+		ParserFunc* top; // innermost function
+		int depth;
+		ParserFunc* frames[max_sample_frames];
+	};
+
+	// shadow call stack, written by interpreter, read by signal handler
+	ParserFunc* m_frames[max_frames];
+	volatile int m_depth;
+
+	Sample m_ring[ring_size];
+	unsigned int m_write; // written by signal handler only
+	unsigned int m_read; // written by interpreter only
+	unsigned long long m_dropped;
+
+	const ExecutionState* m_exec;
+	int m_interval; // microseconds
+	unsigned long long m_samples;
+	std::map<std::vector<ParserFunc*>, unsigned long long> m_stacks; // call chain -> samples
+	std::map<std::pair<ParserFunc*, IASTNode*>, unsigned long long> m_nodes;
+
+	static void on_signal(int);
+	void record();
+
+	Sampler(const Sampler&);
+	const Sampler& operator = (const Sampler&);
+public:
+	Sampler(int frequency);
+	~Sampler();
+	// start sampling execution of exec, sampling is process-wide, one sampler at a time
+	void start(const ExecutionState* exec);
+	void stop();
+	void push(ParserFunc* func)
+	{
+		if (m_depth < max_frames) m_frames[m_depth] = func;
+		__atomic_signal_fence(__ATOMIC_SEQ_CST); // frame is visible before depth
+		m_depth = m_depth + 1;
+	}
+	void pop() { m_depth = m_depth - 1; }
+	int backlog() const { return __atomic_load_n(&m_write, __ATOMIC_ACQUIRE) - m_read >= ring_size / 2; }
+	void drain();
+	// hottest functions and source positions by samples
+	void print_report(std::ostream& out, unsigned int max_nodes) const;
+	// one line "main;f;g samples" per call chain, input of flame graph tools
+	void print_folded(std::ostream& out) const;
+};
+
+#endif // SAMPLER_H
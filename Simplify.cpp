@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Simplify.h"
+#include "AbstractSyntaxTree.h"
+#include "ParserFunc.h"
+
+static unsigned int count_nodes(IASTNode* node)
+{
+	if (node == NULL) return 0;
+	unsigned int count = 1;
+	for (int i = 0; i < node->child_count(); i++) count += count_nodes(node->get_child(i));
+	return count;
+}
+
+static double number(IASTNode* node)
+{
+	return dynamic_cast<ASTLeafNum*>(node)->get();
+}
+
+// node is number equal to value with the same sign of zero
+static int is_number(IASTNode* node, double value)
+{
+	if (node->get_op() != NUMBER) return 0;
+	double n = number(node);
+	return n == value && std::signbit(n) == std::signbit(value);
+}
+
+// new leaf in place of node, node is deleted
+static IASTNode* replace_by_number(IASTNode* node, double value)
+{
+	ASTLeafNum* leaf = new ASTLeafNum(value);
+	leaf->set_location(node->get_location());
+	delete node;
+	return leaf;
+}
+
+// child num in place of node, rest of node is deleted
+static IASTNode* replace_by_child(IASTNode* node, int num)
+{
+	IASTNode* child = node->get_child(num);
+	node->set_child(num, NULL);
+	delete node;
+	return child;
+}
+
+// value of operation as computed by interpreter, return 0 if it fails at run time
+static int fold_binary(int op, double left, double right, double& res)
+{
+	switch (op) {
+	case EQUALITY: res = double_equal(left, right) ? 1.0 : 0.0; break;
+	case NEQUALITY: res = double_equal(left, right) ? 0.0 : 1.0; break;
+	case GREATER: res = left > right ? 1.0 : 0.0; break;
+	case GREATER_EQUAL: res = left > right || double_equal(left, right) ? 1.0 : 0.0; break;
+	case LESS: res = left < right ? 1.0 : 0.0; break;
+	case LESS_EQUAL: res = left < right || double_equal(left, right) ? 1.0 : 0.0; break;
+	case ADD: res = left + right; break;
+	case SUB: res = left - right; break;
+	case MUL: res = left * right; break;
+	case DIV:
+		if (double_equal(right, 0.0)) return 0; // division by zero is reported at run time
+		res = left / right;
+		break;
+	default:
+		return 0;
+	}
+	return 1;
+}
+
+// 1 / value if value is power of two, x / value and x * (1 / value) are equal then
+static int exact_reciprocal(double value, double& res)
+{
+	int exp;
+	if (double_equal(value, 0.0) || fabs(frexp(value, &exp)) != 0.5 || exp < -1000 || exp > 1000) return 0;
+	res = 1.0 / value;
+	return 1;
+}
+
+static IASTNode* simplify(IASTNode* node)
+{
+	for (int i = 0; i < node->child_count(); i++) {
+		IASTNode* child = node->get_child(i);
+		IASTNode* simple = simplify(child);
+		if (simple != child) node->set_child(i, simple);
+	}
+
+	int op = node->get_op();
+	switch (op) {
+	case UNARY_MINUS:
+	case NOT: {
+		IASTNode* child = node->get_child(0);
+		if (child->get_op() == NUMBER) {
+			double value = number(child);
+			if (op == UNARY_MINUS) return replace_by_number(node, -value);
+			return replace_by_number(node, double_equal(value, 0.0) ? 1.0 : 0.0);
+		}
+		if (op == UNARY_MINUS && child->get_op() == UNARY_MINUS) return replace_by_child(replace_by_child(node, 0), 0);
+		return node;
+	}
+	case EQUALITY: case NEQUALITY:
+	case GREATER: case GREATER_EQUAL: case LESS: case LESS_EQUAL:
+	case ADD: case SUB: case MUL: case DIV: {
+		IASTNode* left = node->get_child(0);
+		IASTNode* right = node->get_child(1);
+		double res;
+		if (left->get_op() == NUMBER && right->get_op() == NUMBER && fold_binary(op, number(left), number(right), res))
+			return replace_by_number(node, res);
+		// x + 0 stays, it is 0 for x = -0
+		if (((op == MUL || op == DIV) && is_number(right, 1.0)) || (op == SUB && is_number(right, 0.0)))
+			return replace_by_child(node, 0);
+		if (op == MUL && is_number(left, 1.0)) return replace_by_child(node, 1);
+		if (op == MUL && (is_number(left, -1.0) || is_number(right, -1.0))) {
+			ASTUnaryOpNode* minus = new ASTUnaryOpNode(UNARY_MINUS);
+			minus->set_location(node->get_location());
+			minus->set(replace_by_child(node, is_number(left, -1.0) ? 1 : 0));
+			return minus;
+		}
+		if (op == DIV && right->get_op() == NUMBER && exact_reciprocal(number(right), res)) {
+			dynamic_cast<ASTLeafNum*>(right)->set(res);
+			node->set_op(MUL);
+		}
+		return node;
+	}
+	case TERNARY:
+	case IF: {
+		IASTNode* condition = node->get_child(0);
+		if (condition->get_op() != NUMBER) return node;
+		return replace_by_child(node, double_equal(number(condition), 0.0) ? 2 : 1);
+	}
+	case WHILE_CYCLE: {
+		IASTNode* condition = node->get_child(0);
+		if (condition->get_op() != NUMBER || !double_equal(number(condition), 0.0)) return node;
+		IASTNode* empty = new ASTEmptyNode;
+		empty->set_location(node->get_location());
+		delete node;
+		return empty;
+	}
+	case STATEMENTS: // results of statements aren't used
+		if (node->get_child(0)->get_op() == EMPTY) return replace_by_child(node, 1);
+		if (node->get_child(1)->get_op() == EMPTY) return replace_by_child(node, 0);
+		return node;
+	default:
+		return node;
+	}
+}
+
+unsigned int simplify_function(ParserFunc* f)
+{
+	if (f->body == NULL) return 0;
+	unsigned int nodes = count_nodes(f->body);
+	f->body = simplify(f->body);
+	return nodes - count_nodes(f->body);
+}
+
+static bool name_less(const ParserFunc* a, const ParserFunc* b)
+{
+	return a->name < b->name;
+}
+
+void simplify_program(HashTable& functable, std::ostream* report)
+{
+	std::vector<ParserFunc*> funcs;
+	functable.get_all(funcs);
+	std::sort(funcs.begin(), funcs.end(), name_less);
+	for (unsigned int i = 0; i < funcs.size(); i++) {
+		unsigned int nodes = count_nodes(funcs[i]->body);
+		unsigned int removed = simplify_function(funcs[i]);
+		if (report != NULL) *report << "simplify '" << funcs[i]->name << "': nodes " << nodes
+			<< ", removed " << removed << std::endl;
+	}
+}
@@ -0,0 +1,16 @@
+#ifndef SIMPLIFY_H
+#define SIMPLIFY_H
+
+#include <ostream>
+
+#include "HashTable.h"
+
+// fold constant expressions, drop identities like x * 1 and -(-x), divide by power of
+// two as multiplication, remove branches of constant conditions; assignments and their
+// trace are unchanged; print nodes removed from every function to report if it isn't NULL
+void simplify_program(HashTable& functable, std::ostream* report);
+
+// return number of nodes removed from body of f
+unsigned int simplify_function(ParserFunc* f);
+
+#endif // SIMPLIFY_H
@@ -4,18 +4,22 @@
 #include <cstdio>
 #include <iostream>
 
+#include "MemoryStats.h"
+
 template <typename T>
 class Stack {
 	struct StackElem {
+		MEMORY_TAG(MEM_STACKS)
 		T m_value;
 		StackElem* m_next;
 		StackElem(const T& value, StackElem* next) : m_value(value), m_next(next) {}
 	};
 	StackElem* m_top;
+	int m_size;
 	const Stack& operator = (const Stack&);
 	Stack(const Stack&);
 public:
-	Stack() : m_top(NULL)
+	Stack() : m_top(NULL), m_size(0)
 	{}
 	~Stack()
 	{
@@ -24,6 +28,7 @@ public:
 	void push(const T& value)
 	{
 		m_top = new StackElem(value, m_top);
+		m_size++;
 	}
 	// return 1 if stack empty, else return 0
 	int pop()
@@ -32,12 +37,21 @@ public:
 		StackElem* temp = m_top->m_next;
 		delete m_top;
 		m_top = temp;
+		m_size--;
 		return 0;
 	}
 	T top() const
 	{
 		return m_top->m_value;
 	}
+	int empty() const
+	{
+		return m_top == NULL;
+	}
+	int size() const
+	{
+		return m_size;
+	}
 	void print()
 	{
 		std::cout << "Stack: ";
@@ -0,0 +1,74 @@
+#include <cstring>
+
+#include "Symbols.h"
+#include "HelpTools.h"
+
+static const size_t initial_slots = 1024;
+
+Interner::Interner() : m_slots(initial_slots, 0), m_mask(initial_slots - 1)
+{
+}
+
+unsigned int Interner::intern(const char* text, size_t length)
+{
+	unsigned long long hash = hash_bytes(text, length);
+	size_t i = hash & m_mask;
+	for (; m_slots[i] != 0; i = (i + 1) & m_mask) {
+		unsigned int atom = m_slots[i] - 1;
+		const std::string& name = m_names[atom];
+		if (m_hashes[atom] == hash && name.size() == length && memcmp(name.data(), text, length) == 0) return atom;
+	}
+	unsigned int atom = m_names.size();
+	m_names.push_back(std::string(text, length));
+	m_hashes.push_back(hash);
+	m_slots[i] = atom + 1;
+	if (2 * m_names.size() > m_slots.size()) grow(); // at most half full
+	return atom;
+}
+
+void Interner::grow()
+{
+	std::vector<unsigned int> slots(2 * m_slots.size(), 0);
+	m_mask = slots.size() - 1;
+	for (unsigned int atom = 0; atom < m_names.size(); atom++) {
+		size_t i = m_hashes[atom] & m_mask;
+		while (slots[i] != 0) i = (i + 1) & m_mask;
+		slots[i] = atom + 1;
+	}
+	m_slots.swap(slots);
+}
+
+void ScopeTable::close()
+{
+	size_t begin = m_scopes.back();
+	m_scopes.pop_back();
+	// reverse order, atom declared twice in scope gets its oldest symbol
+	while (m_saved.size() > begin) {
+		const Saved& saved = m_saved.back();
+		m_symbols[saved.atom] = saved.symbol;
+		m_saved.pop_back();
+	}
+}
+
+void ScopeTable::clear()
+{
+	m_symbols.clear();
+	m_saved.clear();
+	m_scopes.clear();
+}
+
+const ScopeTable::Symbol& ScopeTable::bind(unsigned int atom, unsigned int id, unsigned int size, int slot)
+{
+	if (atom >= m_symbols.size()) {
+		Symbol unbound = { 0, 0, -1, 0 };
+		m_symbols.resize(atom + 1, unbound);
+	}
+	Saved saved = { atom, m_symbols[atom] };
+	m_saved.push_back(saved);
+	Symbol& symbol = m_symbols[atom];
+	symbol.id = id;
+	symbol.size = size;
+	symbol.slot = slot;
+	symbol.depth = m_scopes.size();
+	return symbol;
+}
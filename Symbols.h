@@ -0,0 +1,71 @@
+#ifndef SYMBOLS_H
+#define SYMBOLS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// identifiers of source as small numbers (atoms), equal names have equal atom;
+// scanner interns every name, parser compares and indexes by atom only
+class Interner
+{
+	std::vector<std::string> m_names; // by atom
+	std::vector<unsigned long long> m_hashes; // by atom
+	std::vector<unsigned int> m_slots; // atom + 1, 0 if free, open addressing
+	size_t m_mask; // size of m_slots - 1, size is power of 2
+
+	void grow();
+
+	Interner(const Interner&);
+	const Interner& operator = (const Interner&);
+public:
+	Interner();
+	unsigned int intern(const char* text, size_t length);
+	unsigned int intern(const std::string& name) { return intern(name.data(), name.size()); }
+	const std::string& name(unsigned int atom) const { return m_names[atom]; }
+	unsigned int size() const { return m_names.size(); }
+};
+
+// symbols of names visible in nested scopes, symbol of atom is found by index;
+// symbol shadowed by inner scope is saved and restored when scope is closed
+class ScopeTable
+{
+public:
+	struct Symbol
+	{
+		unsigned int id;
+		unsigned int size; // of array, 0 for variable
+		int slot; // in frame of array, -1 for variable
+		unsigned int depth; // of declaring scope, 0 if atom is not visible
+	};
+private:
+	struct Saved
+	{
+		unsigned int atom;
+		Symbol symbol;
+	};
+	std::vector<Symbol> m_symbols; // by atom
+	std::vector<Saved> m_saved;
+	std::vector<size_t> m_scopes; // size of m_saved when scope was opened
+public:
+	ScopeTable() {}
+	void open() { m_scopes.push_back(m_saved.size()); }
+	void close();
+	void clear();
+	// declare atom in innermost scope, return its symbol
+	const Symbol& bind(unsigned int atom, unsigned int id, unsigned int size, int slot);
+	// NULL if atom is not visible, symbol is valid until next bind()
+	const Symbol* find(unsigned int atom) const
+	{
+		if (atom >= m_symbols.size() || m_symbols[atom].depth == 0) return NULL;
+		return &m_symbols[atom];
+	}
+	// return 1 if atom is declared in innermost scope
+	int local(unsigned int atom) const
+	{
+		const Symbol* symbol = find(atom);
+		return symbol != NULL && symbol->depth == m_scopes.size();
+	}
+};
+
+#endif // SYMBOLS_H
@@ -0,0 +1,111 @@
+#include <sched.h>
+
+#include "ThreadPool.h"
+#include "HelpTools.h"
+
+static __thread int current_worker = 0;
+
+ThreadPool::ThreadPool(int threads) : m_pending(0), m_stop(0)
+{
+	if (threads < 1) threads = 1;
+	pthread_mutex_init(&m_idle_lock, NULL);
+	pthread_cond_init(&m_idle_cond, NULL);
+	for (int i = 0; i < threads; i++) {
+		Worker* w = new Worker;
+		w->pool = this;
+		w->index = i;
+		pthread_mutex_init(&w->lock, NULL);
+		m_workers.push_back(w);
+	}
+	for (int i = 1; i < threads; i++) {
+		if (pthread_create(&m_workers[i]->thread, NULL, worker_main, m_workers[i]) != 0) {
+			calc_unreachable("Cannot create thread");
+		}
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	pthread_mutex_lock(&m_idle_lock);
+	m_stop = 1;
+	pthread_cond_broadcast(&m_idle_cond);
+	pthread_mutex_unlock(&m_idle_lock);
+	for (unsigned int i = 1; i < m_workers.size(); i++) {
+		pthread_join(m_workers[i]->thread, NULL);
+	}
+	for (unsigned int i = 0; i < m_workers.size(); i++) {
+		pthread_mutex_destroy(&m_workers[i]->lock);
+		delete m_workers[i];
+	}
+	pthread_cond_destroy(&m_idle_cond);
+	pthread_mutex_destroy(&m_idle_lock);
+}
+
+Task* ThreadPool::take(int index)
+{
+	Task* task = NULL;
+	Worker* own = m_workers[index];
+	pthread_mutex_lock(&own->lock);
+	if (!own->tasks.empty()) {
+		task = own->tasks.back();
+		own->tasks.pop_back();
+	}
+	pthread_mutex_unlock(&own->lock);
+
+	for (unsigned int i = 1; task == NULL && i < m_workers.size(); i++) {
+		Worker* victim = m_workers[(index + i) % m_workers.size()];
+		pthread_mutex_lock(&victim->lock);
+		if (!victim->tasks.empty()) {
+			task = victim->tasks.front();
+			victim->tasks.pop_front();
+		}
+		pthread_mutex_unlock(&victim->lock);
+	}
+
+	if (task != NULL) __atomic_sub_fetch(&m_pending, 1, __ATOMIC_RELAXED);
+	return task;
+}
+
+void* ThreadPool::worker_main(void* arg)
+{
+	Worker* w = static_cast<Worker*>(arg);
+	ThreadPool* pool = w->pool;
+	current_worker = w->index;
+	while (1) {
+		Task* task = pool->take(w->index);
+		if (task != NULL) {
+			task->execute();
+			continue;
+		}
+		pthread_mutex_lock(&pool->m_idle_lock);
+		while (!pool->m_stop && __atomic_load_n(&pool->m_pending, __ATOMIC_RELAXED) == 0) {
+			pthread_cond_wait(&pool->m_idle_cond, &pool->m_idle_lock);
+		}
+		int stop = pool->m_stop;
+		pthread_mutex_unlock(&pool->m_idle_lock);
+		if (stop) break;
+	}
+	return NULL;
+}
+
+void ThreadPool::submit(Task* task)
+{
+	Worker* own = m_workers[current_worker];
+	pthread_mutex_lock(&own->lock);
+	own->tasks.push_back(task);
+	pthread_mutex_unlock(&own->lock);
+
+	pthread_mutex_lock(&m_idle_lock);
+	__atomic_add_fetch(&m_pending, 1, __ATOMIC_RELAXED);
+	pthread_cond_signal(&m_idle_cond);
+	pthread_mutex_unlock(&m_idle_lock);
+}
+
+void ThreadPool::wait(Task* task)
+{
+	while (!task->done()) {
+		Task* other = take(current_worker);
+		if (other != NULL) other->execute();
+		else sched_yield();
+	}
+}
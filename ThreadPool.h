@@ -0,0 +1,58 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <pthread.h>
+#include <deque>
+#include <vector>
+
+class Task
+{
+	volatile int m_done;
+
+	Task(const Task&);
+	const Task& operator = (const Task&);
+public:
+	Task() : m_done(0) {}
+	virtual ~Task() {}
+	virtual void run() = 0;
+	void execute()
+	{
+		run();
+		__atomic_store_n(&m_done, 1, __ATOMIC_RELEASE);
+	}
+	int done() const { return __atomic_load_n(&m_done, __ATOMIC_ACQUIRE); }
+};
+
+// fixed set of workers, every worker has own deque of tasks
+// owner takes tasks from back, idle workers steal from front
+class ThreadPool
+{
+	struct Worker
+	{
+		ThreadPool* pool;
+		int index;
+		pthread_t thread;
+		pthread_mutex_t lock;
+		std::deque<Task*> tasks;
+	};
+	std::vector<Worker*> m_workers; // worker 0 is thread which created pool
+	pthread_mutex_t m_idle_lock;
+	pthread_cond_t m_idle_cond;
+	int m_pending; // tasks in all deques
+	int m_stop;
+
+	Task* take(int index);
+	static void* worker_main(void* arg);
+
+	ThreadPool(const ThreadPool&);
+	const ThreadPool& operator = (const ThreadPool&);
+public:
+	ThreadPool(int threads);
+	~ThreadPool();
+	int size() const { return m_workers.size(); }
+	void submit(Task* task);
+	// execute other tasks until task is done
+	void wait(Task* task);
+};
+
+#endif // THREADPOOL_H
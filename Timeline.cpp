@@ -0,0 +1,140 @@
+#include <cstring>
+#include <ctime>
+
+#include "Timeline.h"
+#include "AbstractSyntaxTree.h"
+
+Timeline::Timeline(int call_every, int max_depth, unsigned int loop_batch)
+	: m_file(NULL), m_used(0), m_first_event(1), m_start(0.0),
+	m_call_every(call_every < 1 ? 1 : call_every), m_max_depth(max_depth), m_loop_batch(loop_batch),
+	m_calls(0), m_depth(0), m_events(0)
+{}
+
+Timeline::~Timeline()
+{
+	close();
+}
+
+double Timeline::now() const
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+int Timeline::open(const char* file_name)
+{
+	m_file = fopen(file_name, "w");
+	if (m_file == NULL) return 0;
+	m_start = now();
+	const char* header = "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+	write(header, strlen(header));
+	return 1;
+}
+
+void Timeline::write(const char* data, unsigned int size)
+{
+	if (m_used + size > sizeof(m_buffer)) {
+		fwrite(m_buffer, 1, m_used, m_file);
+		m_used = 0;
+	}
+	if (size > sizeof(m_buffer)) {
+		fwrite(data, 1, size, m_file);
+		return;
+	}
+	memcpy(m_buffer + m_used, data, size);
+	m_used += size;
+}
+
+// names are function names, they need no escaping
+void Timeline::event(const char* phase, const char* category, const std::string& name, double ts, const char* extra)
+{
+	char line[512];
+	int len = snprintf(line, sizeof(line), "%s{\"name\": \"%.200s\", \"cat\": \"%s\", \"ph\": \"%s\", \"ts\": %.3f, \"pid\": 1, \"tid\": 1%s}",
+		m_first_event ? "" : ",\n", name.c_str(), category, phase, ts - m_start, extra);
+	if (len >= static_cast<int>(sizeof(line))) len = sizeof(line) - 1;
+	write(line, len);
+	m_first_event = 0;
+	m_events++;
+}
+
+void Timeline::call(const ParserFunc* func)
+{
+	m_depth++;
+	int record = m_depth <= m_max_depth && m_calls++ % m_call_every == 0;
+	m_recorded.push_back(record);
+	m_names.push_back(&func->name);
+	if (record) event("B", "call", func->name, now(), "");
+}
+
+void Timeline::ret()
+{
+	if (m_recorded.empty()) return;
+	double time = now();
+	// loops of returning function are finished
+	while (!m_loops.empty() && m_loops.back().depth == m_depth) {
+		loop_batch(m_loops.back(), time);
+		m_loops.pop_back();
+	}
+	if (m_recorded.back()) event("E", "call", *m_names.back(), time, "");
+	m_recorded.pop_back();
+	m_names.pop_back();
+	m_depth--;
+}
+
+void Timeline::cached_call(const ParserFunc* func)
+{
+	if (m_depth + 1 > m_max_depth || m_calls++ % m_call_every != 0) return;
+	event("i", "memo", func->name, now(), ", \"s\": \"t\"");
+}
+
+void Timeline::loop_batch(const Loop& loop, double end)
+{
+	if (loop.iterations == 0) return;
+	unsigned long long first = (loop.iterations - 1) / m_loop_batch * m_loop_batch;
+	char extra[128];
+	snprintf(extra, sizeof(extra), ", \"dur\": %.3f, \"args\": {\"first\": %llu, \"count\": %llu}",
+		end - loop.batch_start, first, loop.iterations - first);
+	char name[64];
+	snprintf(name, sizeof(name), "while line %u", loop.node->get_location().begin.line);
+	event("X", "loop", name, loop.batch_start, extra);
+}
+
+void Timeline::loop_iteration(IASTNode* loop)
+{
+	if (m_loop_batch == 0 || m_depth > m_max_depth) return;
+	if (m_loops.empty() || m_loops.back().node != loop || m_loops.back().depth != m_depth) {
+		Loop entry;
+		entry.node = loop;
+		entry.depth = m_depth;
+		entry.iterations = 0;
+		entry.batch_start = now();
+		m_loops.push_back(entry);
+	}
+	Loop& entry = m_loops.back();
+	if (entry.iterations > 0 && entry.iterations % m_loop_batch == 0) {
+		double time = now();
+		loop_batch(entry, time);
+		entry.batch_start = time;
+	}
+	entry.iterations++;
+}
+
+void Timeline::loop_end(IASTNode* loop)
+{
+	if (m_loops.empty() || m_loops.back().node != loop || m_loops.back().depth != m_depth) return;
+	loop_batch(m_loops.back(), now());
+	m_loops.pop_back();
+}
+
+void Timeline::close()
+{
+	if (m_file == NULL) return;
+	while (!m_recorded.empty()) ret();
+	const char* footer = "\n]}\n";
+	write(footer, strlen(footer));
+	fwrite(m_buffer, 1, m_used, m_file);
+	m_used = 0;
+	fclose(m_file);
+	m_file = NULL;
+}
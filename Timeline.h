@@ -0,0 +1,63 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class IASTNode;
+struct ParserFunc;
+
+// writes function calls and batches of loop iterations as Chrome trace events,
+// the file can be opened in chrome://tracing or Perfetto
+class Timeline
+{
+	struct Loop
+	{
+		IASTNode* node;
+		int depth; // call depth of loop, recursive calls may run the same loop
+		unsigned long long iterations;
+		double batch_start;
+	};
+
+	FILE* m_file;
+	char m_buffer[64 * 1024];
+	unsigned int m_used;
+	int m_first_event;
+	double m_start;
+
+	int m_call_every; // record one of call_every calls
+	int m_max_depth; // calls deeper than max_depth are not recorded
+	unsigned int m_loop_batch; // iterations in one loop event, 0 disables loop events
+
+	unsigned long long m_calls;
+	int m_depth;
+	std::vector<char> m_recorded; // for every active call, 1 if its begin event was written
+	std::vector<const std::string*> m_names;
+	std::vector<Loop> m_loops;
+	unsigned long long m_events;
+
+	double now() const;
+	void write(const char* data, unsigned int size);
+	void event(const char* phase, const char* category, const std::string& name, double ts, const char* extra);
+	void loop_batch(const Loop& loop, double end);
+
+	Timeline(const Timeline&);
+	const Timeline& operator = (const Timeline&);
+public:
+	Timeline(int call_every, int max_depth, unsigned int loop_batch);
+	~Timeline();
+	// return 0 if file can't be created
+	int open(const char* file_name);
+	void call(const ParserFunc* func);
+	void ret();
+	// call answered from memoization cache
+	void cached_call(const ParserFunc* func);
+	void loop_iteration(IASTNode* loop);
+	void loop_end(IASTNode* loop);
+	// close calls and loops left by error, finish file
+	void close();
+	unsigned long long events() const { return m_events; }
+};
+
+#endif // TIMELINE_H
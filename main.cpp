@@ -1,39 +1,377 @@
 #include <iostream>
+#include <fstream>
+#include <climits>
+#include <map>
+#include <unistd.h>
 
 #include "HelpTools.h"
 #include "ParserDriver.h"
 #include "Interpreter.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
+#include "Sampler.h"
+#include "PhaseStats.h"
+#include "Timeline.h"
+#include "LiveMetrics.h"
+#include "PGOProfile.h"
+#include "ProgramCache.h"
+#include "Batch.h"
+#include "ParallelParse.h"
+#include "LazyParse.h"
+#include "Simplify.h"
+#include "Repl.h"
 
-int main(int argc, char** argv)
+static void usage()
 {
-	if (argc != 3) {
-		std::cout << "Usage: ./calc file.txt mode\n";
-		std::cout << "modes:\n\t-c\tcompiler\n\t-i\tinterpreter\n";
-		exit(-1);
+	std::cout << "Usage: ./calc file.txt mode [options]\n";
+	std::cout << "\tfile - reads program from stdin\n";
+	std::cout << "       ./calc --batch dir [-q] [-w threads] file.txt...\n";
+	std::cout << "\tinterpret programs in parallel, output of every program goes to dir/file.txt.out, file names must differ\n";
+	std::cout << "       ./calc --repl [-q] [-m size] [-O] [file.txt]\n";
+	std::cout << "\tread definitions, expressions and commands from stdin, functions of file stay loaded\n";
+	std::cout << "modes:\n\t-c\tcompiler\n\t-i\tinterpreter\n\t-l\tprint tokens with locations\n";
+	std::cout << "options:\n";
+	std::cout << "\t--stats\t\tprint wall time of every stage, CPU time and max RSS to stderr as JSON\n";
+	std::cout << "\t--perf\t\tadd hardware counters to --stats\n";
+	std::cout << "\t-M\t\tprint memory used by subsystems to stderr at exit and on SIGUSR1\n";
+	std::cout << "\t-L size\t\tabort if memory exceeds size bytes, suffixes K, M, G\n";
+	std::cout << "\t--parse-threads n\tparse functions of large file on n threads\n";
+	std::cout << "\t--scanner name\tflex (default), fast (hand-written, best SIMD of processor), scalar, sse2 or avx2\n";
+	std::cout << "\t--cache dir\tload parsed program from dir instead of parsing, store it there on first run\n";
+	std::cout << "\t-O\t\tfold constants and remove dead branches before run, -s prints nodes removed from every function\n";
+	std::cout << "\t--profile-in file\tcompiler: order blocks and hint branches by profile of interpreter run\n";
+	std::cout << "interpreter options:\n";
+	std::cout << "\t-q\t\tdon't print assignments\n";
+	std::cout << "\t-s\t\tprint statistics to stderr\n";
+	std::cout << "\t-m size\t\tcache up to size results of every pure function\n";
+	std::cout << "\t-j threads\tevaluate independent pure calls in parallel\n";
+	std::cout << "\t-g depth\tevaluate sequentially below depth nested parallel calls (default 8)\n";
+	std::cout << "\t-p\t\tprint profile of functions and hottest nodes to stderr\n";
+	std::cout << "\t-S\t\tsample call stacks, print profile to stderr\n";
+	std::cout << "\t-r rate\t\tsamples per second of CPU time (default 1000)\n";
+	std::cout << "\t-f file\t\twrite profile as folded call stacks for flame graphs, in nanoseconds or samples with -S\n";
+	std::cout << "\t--lazy\t\tparse function bodies on first call, errors of uncalled functions aren't reported\n";
+	std::cout << "\t--live\t\tpublish progress in shared memory /calc.<pid>, shown by calc-top, which removes it after finish\n";
+	std::cout << "\t--profile-out file\trecord branches, loop trip counts and calls for --profile-in\n";
+	std::cout << "\t-t file\t\twrite timeline of calls and loops as Chrome trace (chrome://tracing, Perfetto)\n";
+	std::cout << "\t--trace-every n\trecord one of n calls in timeline (default 1)\n";
+	std::cout << "\t--trace-depth d\tdon't record calls nested deeper than d\n";
+	std::cout << "\t--trace-loops n\tgroup n loop iterations in one timeline event, 0 disables loops (default 1000)\n";
+	exit(-1);
+}
+
+// number with optional K, M or G suffix, 0 on error
+static size_t parse_size(const char* str)
+{
+	char* end;
+	double size = strtod(str, &end);
+	if (*end == 'K' || *end == 'k') size *= 1024.0;
+	else if (*end == 'M' || *end == 'm') size *= 1024.0 * 1024.0;
+	else if (*end == 'G' || *end == 'g') size *= 1024.0 * 1024.0 * 1024.0;
+	else if (*end != '\0') return 0;
+	if (*end != '\0' && end[1] != '\0') return 0;
+	if (size < 1.0) return 0;
+	return static_cast<size_t>(size);
+}
+
+// return 0 if scanner is unknown or processor doesn't support it
+static int select_scanner(ParserDriver& driver, const std::string& name)
+{
+	if (name == "flex") return 1;
+	driver.fast_scanning = true;
+	if (name == "fast") return 1;
+	for (int simd = FastScanner::SCALAR; simd <= FastScanner::AVX2; simd++) {
+		if (name == FastScanner::simd_name(simd)) return driver.fast_scanner.set_simd(simd);
+	}
+	return 0;
+}
+
+// programs are independent, each one has own parser and interpreter
+static int run_batch(int argc, char** argv)
+{
+	int trace = 1;
+	int threads = sysconf(_SC_NPROCESSORS_ONLN);
+	int i = 3;
+	for (; i < argc && argv[i][0] == '-'; i++) {
+		if (strcmp(argv[i], "-q") == 0) {
+			trace = 0;
+		} else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+			threads = atoi(argv[++i]);
+			if (threads <= 0) usage();
+		} else {
+			usage();
+		}
+	}
+	if (i == argc) usage();
+	Batch batch(argv[2], trace);
+	// output keeps only file name, programs writing one output would run at the same time
+	std::map<std::string, std::string> outputs;
+	for (; i < argc; i++) {
+		std::pair<std::map<std::string, std::string>::iterator, bool> added;
+		added = outputs.insert(std::make_pair(batch.output(argv[i]), argv[i]));
+		if (!added.second) {
+			std::cerr << "Programs " << added.first->second << " and " << argv[i] << " have the same output "
+				<< added.first->first << std::endl;
+			return -1;
+		}
+		batch.add(argv[i]);
+	}
+	ThreadPool pool(threads);
+	return batch.run(pool, std::cerr) == 0 ? 0 : -1;
+}
+
+// functions stay parsed between inputs, see Repl
+static int run_repl(int argc, char** argv)
+{
+	int trace = 1;
+	int memo_size = 0;
+	int simplify = 0;
+	const char* file = NULL;
+	for (int i = 2; i < argc; i++) {
+		if (strcmp(argv[i], "-q") == 0) {
+			trace = 0;
+		} else if (strcmp(argv[i], "-O") == 0) {
+			simplify = 1;
+		} else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+			memo_size = atoi(argv[++i]);
+			if (memo_size <= 0) usage();
+		} else if (argv[i][0] != '-' && file == NULL) {
+			file = argv[i];
+		} else {
+			usage();
+		}
+	}
+	Repl repl(trace, memo_size, simplify);
+	if (file != NULL) {
+		try {
+			repl.load(file, std::cout);
+		} catch (std::logic_error& err) {
+			std::cerr << err.what() << std::endl;
+			return -1;
+		}
 	}
+	repl.run(std::cin, std::cout, std::cerr, isatty(STDIN_FILENO));
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc >= 2 && strcmp(argv[1], "--repl") == 0) return run_repl(argc, argv);
+	if (argc < 3) usage();
+	if (strcmp(argv[1], "--batch") == 0) return run_batch(argc, argv);
 
 	std::string file_name(argv[1]);
 	std::string mode(argv[2]);
 
-	ParserDriver driver;
-	if (driver.parse(argv[1])) {
-		calc_unreachable("Parser error");
+	int trace = 1;
+	int stats = 0;
+	int memo_size = 0;
+	int threads = 1;
+	int fork_depth = 8;
+	int profile = 0;
+	int sample = 0;
+	int sample_rate = 1000;
+	const char* folded_file = NULL;
+	int phase_stats = 0;
+	int perf = 0;
+	int memory = 0;
+	size_t memory_limit = 0;
+	const char* timeline_file = NULL;
+	int trace_every = 1;
+	int trace_depth = INT_MAX;
+	int trace_loops = 1000;
+	int live = 0;
+	const char* profile_out = NULL;
+	const char* profile_in = NULL;
+	const char* cache_dir = NULL;
+	int parse_threads = 1;
+	int lazy_parse = 0;
+	int simplify = 0;
+	const char* scanner = "flex";
+	for (int i = 3; i < argc; i++) {
+		if (strcmp(argv[i], "-q") == 0) {
+			trace = 0;
+		} else if (strcmp(argv[i], "-s") == 0) {
+			stats = 1;
+		} else if (strcmp(argv[i], "-O") == 0) {
+			simplify = 1;
+		} else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+			memo_size = atoi(argv[++i]);
+			if (memo_size <= 0) usage();
+		} else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+			threads = atoi(argv[++i]);
+			if (threads <= 0) usage();
+		} else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+			fork_depth = atoi(argv[++i]);
+			if (fork_depth < 0) usage();
+		} else if (strcmp(argv[i], "-p") == 0) {
+			profile = 1;
+		} else if (strcmp(argv[i], "-S") == 0) {
+			sample = 1;
+		} else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+			sample_rate = atoi(argv[++i]);
+			if (sample_rate <= 0) usage();
+		} else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+			folded_file = argv[++i];
+		} else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+			timeline_file = argv[++i];
+		} else if (strcmp(argv[i], "--trace-every") == 0 && i + 1 < argc) {
+			trace_every = atoi(argv[++i]);
+			if (trace_every <= 0) usage();
+		} else if (strcmp(argv[i], "--trace-depth") == 0 && i + 1 < argc) {
+			trace_depth = atoi(argv[++i]);
+			if (trace_depth <= 0) usage();
+		} else if (strcmp(argv[i], "--trace-loops") == 0 && i + 1 < argc) {
+			trace_loops = atoi(argv[++i]);
+			if (trace_loops < 0) usage();
+		} else if (strcmp(argv[i], "--live") == 0) {
+			live = 1;
+		} else if (strcmp(argv[i], "--profile-out") == 0 && i + 1 < argc) {
+			profile_out = argv[++i];
+		} else if (strcmp(argv[i], "--profile-in") == 0 && i + 1 < argc) {
+			profile_in = argv[++i];
+		} else if (strcmp(argv[i], "--parse-threads") == 0 && i + 1 < argc) {
+			parse_threads = atoi(argv[++i]);
+			if (parse_threads <= 0) usage();
+		} else if (strcmp(argv[i], "--lazy") == 0) {
+			lazy_parse = 1;
+		} else if (strcmp(argv[i], "--scanner") == 0 && i + 1 < argc) {
+			scanner = argv[++i];
+		} else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+			cache_dir = argv[++i];
+		} else if (strcmp(argv[i], "--stats") == 0) {
+			phase_stats = 1;
+		} else if (strcmp(argv[i], "--perf") == 0) {
+			phase_stats = 1;
+			perf = 1;
+		} else if (strcmp(argv[i], "-M") == 0) {
+			memory = 1;
+		} else if (strcmp(argv[i], "-L") == 0 && i + 1 < argc) {
+			memory_limit = parse_size(argv[++i]);
+			if (memory_limit == 0) usage();
+		} else {
+			usage();
+		}
 	}
+	if (profile && sample) usage();
+	if (live && (profile || sample)) usage();
+	// hash of source can't be taken before stdin is read
+	if (file_name == "-" && (cache_dir != NULL || profile_in != NULL || profile_out != NULL)) usage();
+	// tokens are printed without parsing
+	if (mode == "-l" && (cache_dir != NULL || parse_threads > 1)) usage();
+	// simplification, memoization, parallel calls and profiler look at bodies of all functions before run
+	if (lazy_parse && (mode != "-i" || cache_dir != NULL || parse_threads > 1 || simplify || memo_size > 0
+		|| threads > 1 || profile || (folded_file != NULL && !sample))) usage();
+
+	// accounting costs every node and stack allocation, it's enabled only when it is read
+	if (memory || memory_limit != 0 || live) MemoryStats::enable();
+	if (memory) MemoryStats::enable_signal_report();
+	MemoryStats::set_limit(memory_limit);
 
+	PhaseStats phases(perf);
+	Timeline timeline(trace_every, trace_depth, trace_loops);
+	LiveMetrics metrics;
+	PGOProfile pgo;
+	ParserDriver driver;
+	LazyProgram lazy(driver); // source of unparsed functions, lives until interpreter ends
+	if (!select_scanner(driver, scanner)) usage();
 	try {
-		if (strcmp(argv[2], "-i") == 0) {
+		// phases of cold start are cache_load, parse and cache_store, of warm start only cache_load
+		ProgramCache cache(cache_dir != NULL ? cache_dir : "");
+		int cached = 0;
+		if (cache_dir != NULL) {
+			phases.begin("cache_load");
+			cached = cache.load(argv[1], driver);
+			phases.end();
+		}
+		if (!cached && mode != "-l") {
+			phases.begin("parse");
+			int res;
+			if (lazy_parse) {
+				res = lazy.parse(argv[1]);
+			} else if (parse_threads > 1) {
+				ThreadPool parse_pool(parse_threads);
+				res = parse_parallel(driver, argv[1], parse_pool);
+			} else {
+				res = driver.parse(argv[1]);
+			}
+			if (res) calc_unreachable("Parser error");
+			phases.end();
+			if (cache_dir != NULL) {
+				phases.begin("cache_store");
+				if (!cache.store(argv[1], driver)) std::cerr << "Warning: cannot store program in cache '" << cache_dir << "'\n";
+				phases.end();
+			}
+		}
+
+		if (simplify && mode != "-l") {
+			phases.begin("simplify");
+			simplify_program(driver.functable, stats ? &std::cerr : NULL);
+			phases.end();
+		}
+
+		if (strcmp(argv[2], "-l") == 0) {
+			phases.begin("scan");
+			driver.tokens(file_name, &std::cout);
+			phases.end();
+		} else if (strcmp(argv[2], "-i") == 0) {
 			Interpreter interpreter(&driver.functable, &driver.sym_table);
+			if (!trace) interpreter.set_trace(NULL);
+			if (memo_size > 0) interpreter.enable_memo(memo_size);
+			ThreadPool pool(threads);
+			if (threads > 1) interpreter.enable_parallel(&pool, fork_depth);
+			Sampler sampler(sample_rate);
+			Profiler* profiler = NULL; // counters of every node, built only when asked for
+			if (sample) interpreter.set_sampler(&sampler);
+			else if (profile || folded_file != NULL) interpreter.set_profiler(profiler = new Profiler(driver.functable));
+			if (timeline_file != NULL) {
+				if (!timeline.open(timeline_file)) calc_unreachable("Cannot open timeline file");
+				interpreter.set_timeline(&timeline);
+			}
+			if (live) {
+				if (!metrics.open()) calc_unreachable("Cannot create shared memory for live metrics");
+				interpreter.set_metrics(&metrics);
+			}
+			if (profile_out != NULL) interpreter.set_pgo(&pgo);
+			phases.begin("interpret");
 			interpreter.run();
+			phases.end();
+			timeline.close();
+			if (profile_out != NULL && !pgo.write(profile_out, file_name)) calc_unreachable("Cannot write profile file");
+			if (profiler != NULL && profile) profiler->print_report(std::cerr, 20);
+			if (sample) sampler.print_report(std::cerr, 20);
+			if (folded_file != NULL) {
+				std::ofstream folded(folded_file);
+				if (!folded) calc_unreachable("Cannot open profile file");
+				if (sample) sampler.print_folded(folded);
+				else profiler->print_folded(folded);
+			}
+			delete profiler;
+			if (memo_size > 0) interpreter.print_memo_stats(std::cerr);
+			if (stats) interpreter.print_array_stats(std::cerr);
 		} else if (strcmp(argv[2], "-c") == 0) {
 			SSAList ssa;
 			ParserFunc* func = driver.functable.get("main");
 			if (func == NULL)
 				calc_unreachable("Function 'main()' not found");
+			ssa.context().symbols = &driver.sym_table;
+			if (profile_in != NULL) {
+				std::string error;
+				if (pgo.load(profile_in, file_name, error)) ssa.context().profile = &pgo;
+				else std::cerr << "Warning: " << error << ", compiling without profile\n";
+			}
+			phases.begin("ast_to_ssa");
 			func->body->make_ssa(ssa);
+			phases.end();
 			std::map<std::string, int> in;
 			std::map<std::string, int> out;
+			phases.begin("make_ssa");
 			ssa.make_ssa(in, out);
+			phases.end();
+			phases.begin("print");
 			ssa.print();
+			std::cout.flush();
+			phases.end();
 		} else {
 			std::cout << "Unknown mode\n";
 			exit(-1);
@@ -41,8 +379,22 @@ int main(int argc, char** argv)
 	}
 		catch (std::logic_error& err) {
 		std::cerr << err.what() << std::endl;
+		timeline.close(); // keep calls recorded before error
+		metrics.close();
+		if (phase_stats) phases.print_json(std::cerr, file_name, mode, err.what());
+		exit(-1);
+	}
+	catch (std::bad_alloc&) {
+		if (MemoryStats::limit_exceeded()) std::cerr << "Memory limit exceeded\n";
+		else std::cerr << "Out of memory\n";
+		if (MemoryStats::enabled()) MemoryStats::print(std::cerr);
+		timeline.close();
+		metrics.close();
+		if (phase_stats) phases.print_json(std::cerr, file_name, mode, "Out of memory");
 		exit(-1);
 	}
+	if (memory) MemoryStats::print(std::cerr);
+	if (phase_stats) phases.print_json(std::cerr, file_name, mode, "ok");
 		
 	return 0;
 }